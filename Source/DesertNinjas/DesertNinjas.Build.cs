@@ -10,5 +10,14 @@ public class DesertNinjas : ModuleRules
 
 		PublicDependencyModuleNames.AddRange(new string[] {
 			"Core", "CoreUObject", "Engine", "InputCore", "Paper2D" });
+
+		// Render thread timing for the hitch monitor
+		PrivateDependencyModuleNames.AddRange(new string[] { "RenderCore" });
+
+		// Content commandlets only run in the editor
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.AddRange(new string[] { "AssetRegistry" });
+		}
 	}
 }
@@ -2,5 +2,19 @@
 
 #include "DesertNinjas.h"
 #include "Modules/ModuleManager.h"
+#include "MemoryBudget.h"
+#include "SideScrollerRelevancy.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, DesertNinjas, "DesertNinjas" );
+DEFINE_STAT(STAT_NetRelevancyChecks);
+DEFINE_STAT(STAT_NetRelevantActors);
+
+class FDesertNinjasModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		DesertNinjasMemory::RegisterLLMTags();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDesertNinjasModule, DesertNinjas, "DesertNinjas" );
@@ -3,3 +3,8 @@
 #pragma once
 
 #include "CoreMinimal.h"
+
+DECLARE_STATS_GROUP(TEXT("DesertNinjas"), STATGROUP_DesertNinjas, STATCAT_Advanced);
+
+/** Object type of defined items' collision volumes. Only DesertNinjas characters overlap it, see DefaultEngine.ini. */
+#define ECC_Collectible ECC_GameTraceChannel1
@@ -1,6 +1,7 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "DesertNinjasCharacter.h"
+#include "DesertNinjas.h"
 #include "PaperFlipbookComponent.h"
 #include "Components/TextRenderComponent.h"
 #include "Components/CapsuleComponent.h"
@@ -8,8 +9,14 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/Controller.h"
+#include "GameFramework/GameStateBase.h"
 #include "Camera/CameraComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameplayScheduler.h"
+#include "InputLatencyTracker.h"
+#include "ItemSystem.h"
+#include "MemoryBudget.h"
+#include "Net/UnrealNetwork.h"
 
 DEFINE_LOG_CATEGORY_STATIC(SideScrollerCharacter, Log, All);
 
@@ -21,6 +28,8 @@ DEFINE_LOG_CATEGORY_STATIC(SideScrollerCharacter, Log, All);
 
 ADesertNinjasCharacter::ADesertNinjasCharacter()
 {
+	DN_LLM_SCOPE(Characters);
+
 	// Use only Yaw from the controller and ignore the rest of the rotation.
 	bUseControllerRotationPitch = false;
 	bUseControllerRotationYaw = true;
@@ -30,6 +39,9 @@ ADesertNinjasCharacter::ADesertNinjasCharacter()
 	GetCapsuleComponent()->SetCapsuleHalfHeight(96.0f);
 	GetCapsuleComponent()->SetCapsuleRadius(40.0f);
 
+	// The only component that overlaps defined items, so the item system never has to check what touched them
+	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Collectible, ECR_Overlap);
+
 	// Create a camera boom attached to the root (capsule)
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
@@ -92,9 +104,44 @@ ADesertNinjasCharacter::ADesertNinjasCharacter()
 	BaseHealth = 65.f;
 	MaxStamina = 150.f;
 	BaseStamina = 120.f;
+	StaminaRegenRate = 10.f;
+	SprintStaminaDrainRate = 25.f;
+	MinSprintStamina = 20.f;
+	RunningSpeed = 600.f;
+	SprintingSpeed = 900.f;
 	Coins = 0;
 }
 
+void ADesertNinjasCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		Stamina.Value = FMath::Min(BaseStamina, MaxStamina);
+		Stamina.Timestamp = GetStaminaTime();
+		SetStaminaRate(GetStaminaRateForStatus());
+	}
+}
+
+void ADesertNinjasCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UItemSystem* ItemSystem = UItemSystem::Get(this))
+	{
+		ItemSystem->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ADesertNinjasCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ADesertNinjasCharacter, Stamina);
+	DOREPLIFETIME_CONDITION(ADesertNinjasCharacter, MovementStatus, COND_OwnerOnly);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Animation
 
@@ -103,39 +150,34 @@ void ADesertNinjasCharacter::Attack()
 	// Flag attack
 	bIsAttacking = true;
 	bIdleWalkRun = false;
+	MarkInputReceived(EInputLatencyAction::Attack);
+
+	if (UInputLatencyTracker::IsLowLatencyEnabled())
+	{
+		ApplyAttack();
+	}
 }
 
 void ADesertNinjasCharacter::ThrowObject()
 {
 	bIsThrowing = true;
 	bIdleWalkRun = false;
+	MarkInputReceived(EInputLatencyAction::Throw);
+
+	if (UInputLatencyTracker::IsLowLatencyEnabled())
+	{
+		ApplyThrow();
+	}
 }
 
 void ADesertNinjasCharacter::UpdateAnimation()
 {
 	if (bIsAttacking) {
-		// Attack only once
-		bIsAttacking = false;
-
-		UPaperFlipbook* DesiredAttackStyle = 
-			(GetCharacterMovement()->IsFalling()) ? JumpAttackAnimation : AttackAnimation;
-		if (GetSprite()->GetFlipbook() != DesiredAttackStyle)
-		{
-			GetSprite()->SetFlipbook(DesiredAttackStyle);
-		}
-		DelayIdleWalkRunAnimationUpdate(0.7f);
+		ApplyAttack();
 	}
 
 	if (bIsThrowing) {
-		bIsThrowing = false;
-		DecreaseStamina();
-		UPaperFlipbook* DesiredThrowingStyle =
-			(GetCharacterMovement()->IsFalling()) ? ThrowObjectJumpAnimation : ThrowObjectAnimation;
-		if (GetSprite()->GetFlipbook() != DesiredThrowingStyle)
-		{
-			GetSprite()->SetFlipbook(DesiredThrowingStyle);
-		}
-		DelayIdleWalkRunAnimationUpdate(0.7f);
+		ApplyThrow();
 	}
 
 	if (bIdleWalkRun) {
@@ -144,14 +186,76 @@ void ADesertNinjasCharacter::UpdateAnimation()
 	
 }
 
+void ADesertNinjasCharacter::ApplyAttack()
+{
+	// Attack only once
+	bIsAttacking = false;
+	MarkInputLatency(EInputLatencyAction::Attack, EInputLatencyStage::Applied);
+
+	UPaperFlipbook* DesiredAttackStyle = 
+		(GetCharacterMovement()->IsFalling()) ? JumpAttackAnimation : AttackAnimation;
+	if (GetSprite()->GetFlipbook() != DesiredAttackStyle)
+	{
+		GetSprite()->SetFlipbook(DesiredAttackStyle);
+	}
+	MarkInputLatency(EInputLatencyAction::Attack, EInputLatencyStage::Flipbook);
+	DelayIdleWalkRunAnimationUpdate(0.7f);
+}
+
+void ADesertNinjasCharacter::ApplyThrow()
+{
+	bIsThrowing = false;
+	DecreaseStamina();
+	MarkInputLatency(EInputLatencyAction::Throw, EInputLatencyStage::Applied);
+
+	UPaperFlipbook* DesiredThrowingStyle =
+		(GetCharacterMovement()->IsFalling()) ? ThrowObjectJumpAnimation : ThrowObjectAnimation;
+	if (GetSprite()->GetFlipbook() != DesiredThrowingStyle)
+	{
+		GetSprite()->SetFlipbook(DesiredThrowingStyle);
+	}
+	MarkInputLatency(EInputLatencyAction::Throw, EInputLatencyStage::Flipbook);
+	DelayIdleWalkRunAnimationUpdate(0.7f);
+}
+
 void ADesertNinjasCharacter::Jump() {
+	MarkInputReceived(EInputLatencyAction::Jump);
 	Super::Jump();
 	UE_LOG(LogTemp, Warning, TEXT("Jumping"));
 	bIdleWalkRun = false;
 	GetSprite()->SetFlipbook(JumpAnimation);
+	MarkInputLatency(EInputLatencyAction::Jump, EInputLatencyStage::Flipbook);
 	DelayIdleWalkRunAnimationUpdate(0.7f);
 }
 
+void ADesertNinjasCharacter::OnJumped_Implementation()
+{
+	Super::OnJumped_Implementation();
+
+	// The movement component performs the jump later in the frame, or a later one
+	MarkInputLatency(EInputLatencyAction::Jump, EInputLatencyStage::Applied);
+}
+
+void ADesertNinjasCharacter::MarkInputReceived(EInputLatencyAction Action)
+{
+	if (!IsLocallyControlled()) return;
+
+	if (UInputLatencyTracker* Tracker = UInputLatencyTracker::Get(this))
+	{
+		Tracker->MarkInput(this, Action);
+	}
+}
+
+void ADesertNinjasCharacter::MarkInputLatency(EInputLatencyAction Action, EInputLatencyStage Stage)
+{
+	if (!IsLocallyControlled()) return;
+
+	if (UInputLatencyTracker* Tracker = UInputLatencyTracker::Get(this))
+	{
+		Tracker->MarkStage(this, Action, Stage);
+	}
+}
+
 void ADesertNinjasCharacter::UpdateBasicAnimation() {
 	// Resume normal behavior 
 	bIdleWalkRun = true;
@@ -172,8 +276,145 @@ void ADesertNinjasCharacter::UpdateBasicAnimation() {
 
 void ADesertNinjasCharacter::DecreaseStamina()
 {
-	if (BaseStamina > 10) {
-		BaseStamina -= 10;
+	// The server spends stamina, the owning client predicts it until the next OnRep_Stamina
+	if (!HasAuthority())
+	{
+		if (!IsLocallyControlled()) return;
+		ServerDecreaseStamina();
+	}
+
+	const float Now = GetStaminaTime();
+	if (Stamina.Evaluate(Now, MaxStamina) > 10) {
+		Stamina.Rebase(Now, MaxStamina, Stamina.Rate);
+		Stamina.Value -= 10;
+		BaseStamina = Stamina.Value;
+		ScheduleStaminaThreshold();
+	}
+}
+
+void ADesertNinjasCharacter::ServerDecreaseStamina_Implementation()
+{
+	DecreaseStamina();
+}
+
+float ADesertNinjasCharacter::GetStaminaTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+float ADesertNinjasCharacter::GetStamina() const
+{
+	return Stamina.Evaluate(GetStaminaTime(), MaxStamina);
+}
+
+float ADesertNinjasCharacter::GetStaminaRateForStatus() const
+{
+	switch (MovementStatus)
+	{
+	case EMovementStatus::EMS_Sprinting:
+		return -SprintStaminaDrainRate;
+	case EMovementStatus::EMS_Dead:
+		return 0.f;
+	default:
+		return StaminaRegenRate;
+	}
+}
+
+void ADesertNinjasCharacter::SetStaminaRate(float NewRate)
+{
+	Stamina.Rebase(GetStaminaTime(), MaxStamina, NewRate);
+	BaseStamina = Stamina.Value;
+	ScheduleStaminaThreshold();
+}
+
+void ADesertNinjasCharacter::ScheduleStaminaThreshold()
+{
+	UGameplayScheduler* Scheduler = UGameplayScheduler::Get(this);
+	if (!Scheduler) return;
+
+	// Nothing is evaluated until stamina actually reaches empty or full
+	const float Delay = Stamina.TimeToLimit(GetStaminaTime(), MaxStamina);
+	if (Delay >= 0.f)
+	{
+		Scheduler->SetTimer(StaminaThresholdTimer, this, &ADesertNinjasCharacter::OnStaminaThreshold, Delay);
+	}
+	else
+	{
+		Scheduler->ClearTimer(StaminaThresholdTimer);
+	}
+}
+
+void ADesertNinjasCharacter::OnStaminaThreshold()
+{
+	const bool bDepleted = Stamina.Rate < 0.f;
+	if (bDepleted && HasAuthority() && MovementStatus == EMovementStatus::EMS_Sprinting)
+	{
+		SetMovementStatus(EMovementStatus::EMS_Normal);
+	}
+
+	BaseStamina = GetStamina();
+	if (bDepleted)
+	{
+		OnStaminaDepletedBP();
+	}
+	else
+	{
+		OnStaminaFullBP();
+	}
+}
+
+void ADesertNinjasCharacter::OnRep_Stamina()
+{
+	BaseStamina = GetStamina();
+	ScheduleStaminaThreshold();
+}
+
+void ADesertNinjasCharacter::StartSprinting()
+{
+	if (MovementStatus == EMovementStatus::EMS_Sprinting || MovementStatus == EMovementStatus::EMS_Dead) return;
+	if (GetStamina() < MinSprintStamina) return;
+
+	SetMovementStatus(EMovementStatus::EMS_Sprinting);
+	if (!HasAuthority())
+	{
+		ServerSetSprinting(true);
+	}
+}
+
+void ADesertNinjasCharacter::StopSprinting()
+{
+	if (MovementStatus != EMovementStatus::EMS_Sprinting) return;
+
+	SetMovementStatus(EMovementStatus::EMS_Normal);
+	if (!HasAuthority())
+	{
+		ServerSetSprinting(false);
+	}
+}
+
+void ADesertNinjasCharacter::ServerSetSprinting_Implementation(bool bSprinting)
+{
+	if (bSprinting)
+	{
+		StartSprinting();
+		if (MovementStatus != EMovementStatus::EMS_Sprinting)
+		{
+			ClientCancelSprint();
+		}
+	}
+	else
+	{
+		StopSprinting();
+	}
+}
+
+void ADesertNinjasCharacter::ClientCancelSprint_Implementation()
+{
+	if (MovementStatus == EMovementStatus::EMS_Sprinting)
+	{
+		MovementStatus = EMovementStatus::EMS_Normal;
+		ApplyMovementSpeed();
 	}
 }
 
@@ -214,6 +455,12 @@ void ADesertNinjasCharacter::Tick(float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
+	// Keep the HUD value current for the local player only, stamina itself never ticks
+	if (IsLocallyControlled())
+	{
+		BaseStamina = GetStamina();
+	}
+
 	// There is no need to do anything if the character is dead
 	if (MovementStatus == EMovementStatus::EMS_Dead) return;
 
@@ -236,6 +483,8 @@ void ADesertNinjasCharacter::SetupPlayerInputComponent(class UInputComponent* Pl
 	// Custom actions
 	PlayerInputComponent->BindAction("Attack", IE_Released, this, &ADesertNinjasCharacter::Attack);
 	PlayerInputComponent->BindAction("Throw", IE_Released, this, &ADesertNinjasCharacter::ThrowObject);
+	PlayerInputComponent->BindAction("Sprint", IE_Pressed, this, &ADesertNinjasCharacter::StartSprinting);
+	PlayerInputComponent->BindAction("Sprint", IE_Released, this, &ADesertNinjasCharacter::StopSprinting);
 	
 
 	PlayerInputComponent->BindTouch(IE_Pressed, this, &ADesertNinjasCharacter::TouchStarted);
@@ -285,8 +534,11 @@ void ADesertNinjasCharacter::UpdateCharacter()
 }
 
 void ADesertNinjasCharacter::DelayIdleWalkRunAnimationUpdate(float duration) {
-	GetWorldTimerManager().SetTimer(GeneralTimerHandler, this,
-		&ADesertNinjasCharacter::UpdateBasicAnimation, duration, false);
+	if (UGameplayScheduler* Scheduler = UGameplayScheduler::Get(this))
+	{
+		Scheduler->SetTimer(AnimationRecoveryTimer, this,
+			&ADesertNinjasCharacter::UpdateBasicAnimation, duration);
+	}
 }
 
 void ADesertNinjasCharacter::Die() {
@@ -294,8 +546,12 @@ void ADesertNinjasCharacter::Die() {
 
 	// Set character animation to die 
 	GetSprite()->SetFlipbook(DieAnimation);
-	GetWorldTimerManager().SetTimer(GeneralTimerHandler, this,
-		&ADesertNinjasCharacter::SetStayDead, 0.5f, false);
+	if (UGameplayScheduler* Scheduler = UGameplayScheduler::Get(this))
+	{
+		// A pending recovery would bring back the idle animation
+		Scheduler->ClearTimer(AnimationRecoveryTimer);
+		Scheduler->SetTimer(StayDeadTimer, this, &ADesertNinjasCharacter::SetStayDead, 0.5f);
+	}
 	
 	// Set character status to di
 	SetMovementStatus(EMovementStatus::EMS_Dead);
@@ -309,4 +565,22 @@ void ADesertNinjasCharacter::SetStayDead()
 void ADesertNinjasCharacter::SetMovementStatus(EMovementStatus Status)
 {
 	MovementStatus = Status;
+	ApplyMovementSpeed();
+
+	if (HasAuthority())
+	{
+		SetStaminaRate(GetStaminaRateForStatus());
+	}
+}
+
+void ADesertNinjasCharacter::OnRep_MovementStatus()
+{
+	// Overrides a prediction the server disagreed with, e.g. a sprint that ran out of stamina
+	ApplyMovementSpeed();
+}
+
+void ADesertNinjasCharacter::ApplyMovementSpeed()
+{
+	GetCharacterMovement()->MaxWalkSpeed =
+		(MovementStatus == EMovementStatus::EMS_Sprinting) ? SprintingSpeed : RunningSpeed;
 }
@@ -4,8 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "PaperCharacter.h"
+#include "GameplayTimingWheel.h"
+#include "LazyStamina.h"
 #include "DesertNinjasCharacter.generated.h"
 
+enum class EInputLatencyAction : uint8;
+enum class EInputLatencyStage : uint8;
+
 class UTextRenderComponent;
 
 UENUM(BlueprintType)
@@ -87,10 +92,13 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item | Sounds")
 	class USoundCue* WalkingSound;
 
-	// Indicates the movement status of the player 
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "Enums")
+	// Indicates the movement status of the player, decided by the server
+	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_MovementStatus, Category = "Enums")
 	EMovementStatus MovementStatus;
 
+	UFUNCTION()
+	void OnRep_MovementStatus();
+
 
 	/** Called for side to side input */
 	void MoveRight(float Value);
@@ -121,6 +129,17 @@ protected:
 	// The player is an idle, walk, or run state 
 	bool bIdleWalkRun;
 	virtual void Jump() override;
+
+	// Sprint while stamina lasts
+	void StartSprinting();
+	void StopSprinting();
+
+	UFUNCTION(Server, Reliable)
+	void ServerSetSprinting(bool bSprinting);
+
+	// The server refused a predicted sprint, its status didn't change so it won't replicate
+	UFUNCTION(Client, Reliable)
+	void ClientCancelSprint();
 	 
 
 public:
@@ -133,8 +152,9 @@ public:
 	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 
 protected:
-	// Delay
-	FTimerHandle GeneralTimerHandler;
+	// Delay, one timer per purpose so actions don't cancel each other
+	FGameplayTimerHandle AnimationRecoveryTimer;
+	FGameplayTimerHandle StayDeadTimer;
 	void DelayIdleWalkRunAnimationUpdate(float duration);
 
 	/** Called to choose the correct animation to play 
@@ -145,14 +165,57 @@ protected:
 	// Return to basic animation movement (idle to run)
 	void UpdateBasicAnimation();
 
+	// Play a pending attack or throw, from UpdateAnimation or straight from input in low latency mode
+	void ApplyAttack();
+	void ApplyThrow();
+
+	// Input latency tracking, local players only
+	void MarkInputLatency(EInputLatencyAction Action, EInputLatencyStage Stage);
+	void MarkInputReceived(EInputLatencyAction Action);
+
+	virtual void OnJumped_Implementation() override;
+
 	// Sets the movement status of the character
 	void SetMovementStatus(EMovementStatus Status);
 
+	// Walk speed for the current movement status
+	void ApplyMovementSpeed();
+
 	// Kill the character
 	void Die();
 
 	void SetStayDead();
 
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Stamina, evaluated lazily from the replicated (value, rate, timestamp) */
+	UPROPERTY(ReplicatedUsing = OnRep_Stamina)
+	FLazyStamina Stamina;
+
+	UFUNCTION()
+	void OnRep_Stamina();
+
+	// Time base shared by server and clients
+	float GetStaminaTime() const;
+
+	// Continue from the current stamina at a new rate and schedule the next threshold event
+	void SetStaminaRate(float NewRate);
+
+	// Rate stamina changes at in the current movement status
+	float GetStaminaRateForStatus() const;
+
+	UFUNCTION(Server, Reliable)
+	void ServerDecreaseStamina();
+
+	// Fires when stamina runs out or fills up
+	FGameplayTimerHandle StaminaThresholdTimer;
+	void ScheduleStaminaThreshold();
+	void OnStaminaThreshold();
+
 public:
 	/** Stats */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Stats")
@@ -164,9 +227,37 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Stats")
 	float MaxStamina;
 
+	/** Starting stamina. Kept in sync for the locally controlled character, use GetStamina elsewhere. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Stats")
 	float BaseStamina;
 
+	/** Stamina regenerated per second while not sprinting */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Stats")
+	float StaminaRegenRate;
+
+	/** Stamina drained per second while sprinting */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Stats")
+	float SprintStaminaDrainRate;
+
+	/** Stamina needed to start sprinting */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Stats")
+	float MinSprintStamina;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Stats")
+	float RunningSpeed;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Player Stats")
+	float SprintingSpeed;
+
+	UFUNCTION(BlueprintPure, Category = "Player Stats")
+	float GetStamina() const;
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Player Stats")
+	void OnStaminaDepletedBP();
+
+	UFUNCTION(BlueprintImplementableEvent, Category = "Player Stats")
+	void OnStaminaFullBP();
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Player Stats")
 	int32 Coins;
 
@@ -2,9 +2,103 @@
 
 #include "DesertNinjasGameMode.h"
 #include "DesertNinjasCharacter.h"
+#include "DesertNinjasGameState.h"
+#include "DesertNinjasPlayerController.h"
+#include "GameplayScheduler.h"
+#include "MemoryBudget.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogLoadTest, Log, All);
 
 ADesertNinjasGameMode::ADesertNinjasGameMode()
 {
 	// Set default pawn class to our character
 	DefaultPawnClass = ADesertNinjasCharacter::StaticClass();	
+
+	// Tracks collected items per level
+	GameStateClass = ADesertNinjasGameState::StaticClass();
+
+	// Can drive its pawn as a bot for load tests
+	PlayerControllerClass = ADesertNinjasPlayerController::StaticClass();
+
+	LoadTestTickTotalMs = 0.0;
+	LoadTestTickMaxMs = 0.0;
+	LoadTestFrames = 0;
+	TickStartCycles = 0;
+}
+
+void ADesertNinjasGameMode::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("LoadTestReport")))
+	{
+		WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &ADesertNinjasGameMode::OnWorldTickStart);
+		EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &ADesertNinjasGameMode::OnEndFrame);
+		if (UGameplayScheduler* Scheduler = UGameplayScheduler::Get(this))
+		{
+			Scheduler->SetTimer(LoadTestReportTimer, this, &ADesertNinjasGameMode::ReportLoadTestStats, 1.f, true);
+		}
+	}
+
+#if !UE_BUILD_SHIPPING
+	if (GetDefault<UMemoryBudgetSettings>()->bCheckOnBeginPlay)
+	{
+		DesertNinjasMemory::CheckBudgets(GetWorld());
+	}
+#endif
+}
+
+void ADesertNinjasGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ADesertNinjasGameMode::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		TickStartCycles = FPlatformTime::Cycles();
+	}
+}
+
+void ADesertNinjasGameMode::OnEndFrame()
+{
+	// Measured ourselves, GGameThreadTime is only updated by viewport drawing and a dedicated server has none.
+	// Starting at the world tick leaves out the time a dedicated server sleeps to hold its tick rate.
+	if (TickStartCycles == 0) return;
+
+	const double TickMs = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - TickStartCycles);
+	TickStartCycles = 0;
+	LoadTestTickTotalMs += TickMs;
+	LoadTestTickMaxMs = FMath::Max(LoadTestTickMaxMs, TickMs);
+	++LoadTestFrames;
+}
+
+void ADesertNinjasGameMode::ReportLoadTestStats()
+{
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	const float InKBps = NetDriver ? NetDriver->InBytesPerSecond / 1024.f : 0.f;
+	const float OutKBps = NetDriver ? NetDriver->OutBytesPerSecond / 1024.f : 0.f;
+	const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+	// Parsed by Tools/LoadTest/bot_load_test.sh, keep the format stable
+	UE_LOG(LogLoadTest, Display, TEXT("LoadTestReport players=%d tick_avg_ms=%.2f tick_max_ms=%.2f in_kbps=%.1f out_kbps=%.1f mem_mb=%.1f"),
+		GetNumPlayers(),
+		LoadTestFrames > 0 ? LoadTestTickTotalMs / LoadTestFrames : 0.0,
+		LoadTestTickMaxMs,
+		InKBps,
+		OutKBps,
+		MemoryStats.UsedPhysical / (1024.0 * 1024.0));
+
+	LoadTestTickTotalMs = 0.0;
+	LoadTestTickMaxMs = 0.0;
+	LoadTestFrames = 0;
 }
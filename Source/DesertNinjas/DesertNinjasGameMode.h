@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "GameplayTimingWheel.h"
 #include "DesertNinjasGameMode.generated.h"
 
 /**
@@ -18,4 +19,21 @@ class ADesertNinjasGameMode : public AGameModeBase
 	GENERATED_BODY()
 public:
 	ADesertNinjasGameMode();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Load testing: started with -LoadTestReport the server logs one line of capacity stats per second */
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnEndFrame();
+	void ReportLoadTestStats();
+
+	FGameplayTimerHandle LoadTestReportTimer;
+	FDelegateHandle WorldTickStartHandle;
+	FDelegateHandle EndFrameHandle;
+	double LoadTestTickTotalMs;
+	double LoadTestTickMaxMs;
+	int32 LoadTestFrames;
+	uint32 TickStartCycles;
 };
@@ -0,0 +1,418 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BakeSpriteAtlasCommandlet.h"
+#include "SpriteAtlasTable.h"
+
+#if WITH_EDITOR
+#include "AssetRegistryModule.h"
+#include "Engine/Texture2D.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "PaperSprite.h"
+#include "UObject/Package.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogSpriteAtlas, Log, All);
+
+UBakeSpriteAtlasCommandlet::UBakeSpriteAtlasCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+namespace
+{
+	const TCHAR* AtlasOutputPath = TEXT("/Game/Atlases");
+
+	struct FAtlasGroup
+	{
+		FString Name;
+		FString Path;
+	};
+
+	/** A unique source rectangle; sprites cut from the same region share one */
+	struct FFrameRect
+	{
+		UTexture2D* Texture = nullptr;
+		FIntPoint Offset = FIntPoint::ZeroValue;
+		FIntPoint Size = FIntPoint::ZeroValue;
+		TArray<UPaperSprite*> Sprites;
+
+		int32 Page = INDEX_NONE;
+		FIntPoint AtlasOffset = FIntPoint::ZeroValue;
+	};
+
+	/** Shelf packer: frames sorted tallest first fill rows left to right */
+	class FShelfPacker
+	{
+	public:
+		FShelfPacker(int32 InPageSize, int32 InPadding)
+			: PageSize(InPageSize)
+			, Padding(InPadding)
+		{
+		}
+
+		bool Insert(const FIntPoint& Size, int32& OutPage, FIntPoint& OutOffset)
+		{
+			const int32 Width = Size.X + Padding;
+			const int32 Height = Size.Y + Padding;
+			if (Width > PageSize || Height > PageSize) return false;
+
+			if (UsedHeights.Num() == 0)
+			{
+				StartPage();
+			}
+			if (CursorX + Width > PageSize)
+			{
+				ShelfY += ShelfHeight;
+				CursorX = 0;
+				ShelfHeight = 0;
+			}
+			if (ShelfY + Height > PageSize)
+			{
+				StartPage();
+			}
+
+			OutPage = UsedHeights.Num() - 1;
+			OutOffset = FIntPoint(CursorX, ShelfY);
+			CursorX += Width;
+			ShelfHeight = FMath::Max(ShelfHeight, Height);
+			UsedHeights.Last() = ShelfY + ShelfHeight;
+			return true;
+		}
+
+		// Every page is PageSize wide and trimmed to the next power of two above its used height
+		FIntPoint GetPageSize(int32 Page) const
+		{
+			return FIntPoint(PageSize, FMath::Min(PageSize, (int32)FMath::RoundUpToPowerOfTwo(UsedHeights[Page])));
+		}
+
+		int32 GetNumPages() const { return UsedHeights.Num(); }
+
+	private:
+		void StartPage()
+		{
+			UsedHeights.Add(0);
+			CursorX = 0;
+			ShelfY = 0;
+			ShelfHeight = 0;
+		}
+
+		int32 PageSize;
+		int32 Padding;
+		int32 CursorX = 0;
+		int32 ShelfY = 0;
+		int32 ShelfHeight = 0;
+		TArray<int32> UsedHeights;
+	};
+
+	bool SaveAsset(UObject* Asset)
+	{
+		UPackage* Package = Asset->GetOutermost();
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+		return UPackage::SavePackage(Package, Asset, RF_Public | RF_Standalone, *Filename);
+	}
+
+	/** Removes pages left over from an earlier bake that needed more of them */
+	void DeleteStalePages(const FAtlasGroup& Group, int32 FirstStalePage, const TSet<UTexture2D*>& StillReferenced)
+	{
+		for (int32 Page = FirstStalePage; ; ++Page)
+		{
+			const FString AssetName = FString::Printf(TEXT("%s_AtlasPage%d"), *Group.Name, Page);
+			const FString PackageName = FString::Printf(TEXT("%s/%s"), AtlasOutputPath, *AssetName);
+			FString Filename;
+			if (!FPackageName::DoesPackageExist(PackageName, nullptr, &Filename)) break;
+
+			UPackage* Package = LoadPackage(nullptr, *PackageName, LOAD_None);
+			UTexture2D* PageTexture = Package ? FindObject<UTexture2D>(Package, *AssetName) : nullptr;
+			if (PageTexture && StillReferenced.Contains(PageTexture))
+			{
+				UE_LOG(LogSpriteAtlas, Warning, TEXT("Keeping stale page %s, unbaked sprites still use it"), *AssetName);
+				continue;
+			}
+
+			if (PageTexture)
+			{
+				FAssetRegistryModule::AssetDeleted(PageTexture);
+				PageTexture->ClearFlags(RF_Public | RF_Standalone);
+				PageTexture->MarkPendingKill();
+			}
+			if (Package)
+			{
+				ResetLoaders(Package);
+			}
+			IFileManager::Get().Delete(*Filename);
+			UE_LOG(LogSpriteAtlas, Display, TEXT("Deleted stale page %s"), *AssetName);
+		}
+	}
+
+	template <typename T>
+	T* FindOrCreateAsset(const FString& AssetName)
+	{
+		const FString PackageName = FString::Printf(TEXT("%s/%s"), AtlasOutputPath, *AssetName);
+		UPackage* Package = CreatePackage(nullptr, *PackageName);
+		Package->FullyLoad();
+
+		T* Asset = FindObject<T>(Package, *AssetName);
+		if (!Asset)
+		{
+			Asset = NewObject<T>(Package, FName(*AssetName), RF_Public | RF_Standalone);
+			FAssetRegistryModule::AssetCreated(Asset);
+		}
+		return Asset;
+	}
+
+	int64 BakeGroup(const FAtlasGroup& Group, int32 AtlasSize, int32 Padding, bool bDryRun, int64& OutBytesBefore)
+	{
+		IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssetsByPath(FName(*Group.Path), Assets, true);
+		Assets.Sort([](const FAssetData& A, const FAssetData& B) { return A.ObjectPath.LexicalLess(B.ObjectPath); });
+
+		// Gather the unique source rectangles
+		TArray<FFrameRect> Frames;
+		TSet<UTexture2D*> SourceTextures;
+		for (const FAssetData& AssetData : Assets)
+		{
+			if (AssetData.AssetClass != UPaperSprite::StaticClass()->GetFName()) continue;
+
+			UPaperSprite* Sprite = Cast<UPaperSprite>(AssetData.GetAsset());
+			UTexture2D* Texture = Sprite ? Sprite->GetSourceTexture() : nullptr;
+			if (!Texture) continue;
+
+			if (Texture->Source.GetFormat() != TSF_BGRA8)
+			{
+				UE_LOG(LogSpriteAtlas, Warning, TEXT("Skipping %s: source texture %s is not BGRA8"), *Sprite->GetPathName(), *Texture->GetName());
+				continue;
+			}
+
+			const FIntPoint Offset = Sprite->GetSourceUV().IntPoint();
+			const FIntPoint Size = Sprite->GetSourceSize().IntPoint();
+			FFrameRect* Frame = Frames.FindByPredicate([&](const FFrameRect& Existing)
+			{
+				return Existing.Texture == Texture && Existing.Offset == Offset && Existing.Size == Size;
+			});
+			if (!Frame)
+			{
+				Frame = &Frames.AddDefaulted_GetRef();
+				Frame->Texture = Texture;
+				Frame->Offset = Offset;
+				Frame->Size = Size;
+			}
+			Frame->Sprites.Add(Sprite);
+			SourceTextures.Add(Texture);
+		}
+
+		if (Frames.Num() == 0)
+		{
+			UE_LOG(LogSpriteAtlas, Warning, TEXT("Group %s: no sprites found under %s"), *Group.Name, *Group.Path);
+			OutBytesBefore = 0;
+			return 0;
+		}
+
+		int64 BytesBefore = 0;
+		int64 PixelsBefore = 0;
+		for (UTexture2D* Texture : SourceTextures)
+		{
+			BytesBefore += Texture->CalcTextureMemorySizeEnum(TMC_AllMips);
+			PixelsBefore += (int64)Texture->Source.GetSizeX() * Texture->Source.GetSizeY();
+		}
+		OutBytesBefore = BytesBefore;
+
+		// Pack tallest first so shelves waste little height
+		Frames.StableSort([](const FFrameRect& A, const FFrameRect& B) { return A.Size.Y > B.Size.Y; });
+
+		FShelfPacker Packer(AtlasSize, Padding);
+		int32 NumPacked = 0;
+		for (FFrameRect& Frame : Frames)
+		{
+			if (Packer.Insert(Frame.Size, Frame.Page, Frame.AtlasOffset))
+			{
+				++NumPacked;
+			}
+			else
+			{
+				UE_LOG(LogSpriteAtlas, Warning, TEXT("Frame %s is larger than the atlas page, leaving it unbaked"), *Frame.Sprites[0]->GetName());
+			}
+		}
+
+		const int32 NumPages = Packer.GetNumPages();
+		int64 PagePixels = 0;
+		for (int32 Page = 0; Page < NumPages; ++Page)
+		{
+			PagePixels += (int64)Packer.GetPageSize(Page).X * Packer.GetPageSize(Page).Y;
+		}
+
+		if (bDryRun)
+		{
+			// Assume the pages compress like the textures they replace
+			const int64 Estimate = PixelsBefore > 0 ? (int64)((double)BytesBefore * PagePixels / PixelsBefore) : 0;
+			UE_LOG(LogSpriteAtlas, Display, TEXT("Group %s (dry run): %d frames from %d textures -> %d pages"),
+				*Group.Name, NumPacked, SourceTextures.Num(), NumPages);
+			return Estimate;
+		}
+
+		// Copy all pixels before touching any asset, the sources may be pages from a previous bake
+		TArray<TArray<uint8>> PagePixelData;
+		PagePixelData.SetNum(NumPages);
+		for (int32 Page = 0; Page < NumPages; ++Page)
+		{
+			const FIntPoint PageSize = Packer.GetPageSize(Page);
+			PagePixelData[Page].SetNumZeroed(PageSize.X * PageSize.Y * 4);
+		}
+
+		for (UTexture2D* Texture : SourceTextures)
+		{
+			const int32 SourceWidth = Texture->Source.GetSizeX();
+			const int32 SourceHeight = Texture->Source.GetSizeY();
+			const uint8* SourcePixels = Texture->Source.LockMip(0);
+
+			for (const FFrameRect& Frame : Frames)
+			{
+				if (Frame.Texture != Texture || Frame.Page == INDEX_NONE) continue;
+
+				const int32 PageWidth = Packer.GetPageSize(Frame.Page).X;
+				uint8* Dest = PagePixelData[Frame.Page].GetData();
+				const int32 Rows = FMath::Min(Frame.Size.Y, SourceHeight - Frame.Offset.Y);
+				const int32 RowBytes = FMath::Min(Frame.Size.X, SourceWidth - Frame.Offset.X) * 4;
+				for (int32 Row = 0; Row < Rows; ++Row)
+				{
+					const uint8* Src = SourcePixels + ((Frame.Offset.Y + Row) * SourceWidth + Frame.Offset.X) * 4;
+					uint8* Dst = Dest + ((Frame.AtlasOffset.Y + Row) * PageWidth + Frame.AtlasOffset.X) * 4;
+					FMemory::Memcpy(Dst, Src, RowBytes);
+				}
+			}
+
+			Texture->Source.UnlockMip(0);
+		}
+
+		// Pages inherit sampling and compression from the first source texture
+		UTexture2D* Template = *SourceTextures.CreateConstIterator();
+		USpriteAtlasTable* Table = FindOrCreateAsset<USpriteAtlasTable>(FString::Printf(TEXT("%s_AtlasTable"), *Group.Name));
+		Table->Pages.Reset();
+		Table->Frames.Reset();
+
+		int64 BytesAfter = 0;
+		for (int32 Page = 0; Page < NumPages; ++Page)
+		{
+			const FIntPoint PageSize = Packer.GetPageSize(Page);
+			UTexture2D* PageTexture = FindOrCreateAsset<UTexture2D>(FString::Printf(TEXT("%s_AtlasPage%d"), *Group.Name, Page));
+			PageTexture->Source.Init(PageSize.X, PageSize.Y, 1, 1, TSF_BGRA8, PagePixelData[Page].GetData());
+			PageTexture->CompressionSettings = Template->CompressionSettings;
+			PageTexture->Filter = Template->Filter;
+			PageTexture->LODGroup = Template->LODGroup;
+			PageTexture->MipGenSettings = Template->MipGenSettings;
+			PageTexture->SRGB = Template->SRGB;
+			PageTexture->PostEditChange();
+
+			BytesAfter += PageTexture->CalcTextureMemorySizeEnum(TMC_AllMips);
+			Table->Pages.Add(PageTexture);
+			SaveAsset(PageTexture);
+		}
+
+		for (const FFrameRect& Frame : Frames)
+		{
+			if (Frame.Page == INDEX_NONE) continue;
+
+			UTexture2D* PageTexture = Table->Pages[Frame.Page];
+			for (UPaperSprite* Sprite : Frame.Sprites)
+			{
+				// Keep the pivot where it was relative to the frame
+				const FVector2D OldPivot = Sprite->GetPivotPosition();
+				const FVector2D NewOrigin(Frame.AtlasOffset.X, Frame.AtlasOffset.Y);
+
+				FSpriteAssetInitParameters InitParams;
+				InitParams.Texture = PageTexture;
+				InitParams.Offset = Frame.AtlasOffset;
+				InitParams.Dimension = Frame.Size;
+				InitParams.SetPixelsPerUnrealUnit(Sprite->GetPixelsPerUnrealUnit());
+				Sprite->InitializeSprite(InitParams);
+				Sprite->SetPivotMode(ESpritePivotMode::Custom, OldPivot - FVector2D(Frame.Offset.X, Frame.Offset.Y) + NewOrigin);
+				Sprite->PostEditChange();
+				SaveAsset(Sprite);
+
+				FSpriteAtlasFrame& Entry = Table->Frames.Add(FName(*Sprite->GetPathName()));
+				Entry.Page = Frame.Page;
+				Entry.Offset = Frame.AtlasOffset;
+				Entry.Size = Frame.Size;
+			}
+		}
+
+		SaveAsset(Table);
+
+		// Frames too large to bake keep their old texture, which may be a page of the previous bake
+		TSet<UTexture2D*> StillReferenced;
+		for (const FFrameRect& Frame : Frames)
+		{
+			if (Frame.Page == INDEX_NONE)
+			{
+				StillReferenced.Add(Frame.Texture);
+			}
+		}
+		DeleteStalePages(Group, NumPages, StillReferenced);
+
+		UE_LOG(LogSpriteAtlas, Display, TEXT("Group %s: %d frames from %d textures -> %d pages"),
+			*Group.Name, NumPacked, SourceTextures.Num(), NumPages);
+		return BytesAfter;
+	}
+}
+#endif
+
+int32 UBakeSpriteAtlasCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamVals;
+	ParseCommandLine(*Params, Tokens, Switches, ParamVals);
+
+	TArray<FAtlasGroup> Groups;
+	for (const FString& Switch : Switches)
+	{
+		FString Name;
+		FString Path;
+		if (Switch.StartsWith(TEXT("Group=")) && Switch.Mid(6).Split(TEXT(":"), &Name, &Path))
+		{
+			Groups.Add({ Name, Path });
+		}
+	}
+	if (Groups.Num() == 0)
+	{
+		Groups.Add({ TEXT("Character"), TEXT("/Game/Character/Animation") });
+		Groups.Add({ TEXT("LevelItems"), TEXT("/Game/LevelItems/Sprites") });
+	}
+
+	const FString* AtlasSizeParam = ParamVals.Find(TEXT("AtlasSize"));
+	const FString* PaddingParam = ParamVals.Find(TEXT("Padding"));
+	const int32 AtlasSize = AtlasSizeParam ? FCString::Atoi(**AtlasSizeParam) : 2048;
+	const int32 Padding = PaddingParam ? FCString::Atoi(**PaddingParam) : 2;
+	const bool bDryRun = Switches.Contains(TEXT("DryRun"));
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	int64 TotalBefore = 0;
+	int64 TotalAfter = 0;
+	for (const FAtlasGroup& Group : Groups)
+	{
+		int64 Before = 0;
+		const int64 After = BakeGroup(Group, AtlasSize, Padding, bDryRun, Before);
+		UE_LOG(LogSpriteAtlas, Display, TEXT("Group %s texture memory: %.2f MB -> %.2f MB%s"),
+			*Group.Name, Before / (1024.0 * 1024.0), After / (1024.0 * 1024.0), bDryRun ? TEXT(" (estimated)") : TEXT(""));
+		TotalBefore += Before;
+		TotalAfter += After;
+	}
+
+	UE_LOG(LogSpriteAtlas, Display, TEXT("Total texture memory: %.2f MB -> %.2f MB"),
+		TotalBefore / (1024.0 * 1024.0), TotalAfter / (1024.0 * 1024.0));
+	return 0;
+#else
+	UE_LOG(LogSpriteAtlas, Error, TEXT("BakeSpriteAtlas must be run from the editor"));
+	return 1;
+#endif
+}
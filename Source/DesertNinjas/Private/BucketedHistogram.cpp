@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BucketedHistogram.h"
+
+FBucketedHistogram::FBucketedHistogram()
+	: FBucketedHistogram(TArray<float>{ 1.f, 2.f, 4.f, 8.f, 12.f, 16.7f, 20.f, 25.f, 33.3f, 40.f, 50.f, 66.7f, 83.3f, 100.f, 150.f, 200.f, 300.f, 500.f, 1000.f })
+{
+}
+
+FBucketedHistogram::FBucketedHistogram(TArray<float> InUpperBounds)
+	: UpperBounds(MoveTemp(InUpperBounds))
+{
+	Reset();
+}
+
+void FBucketedHistogram::Add(float Value)
+{
+	Counts[FindBucket(Value)]++;
+	Min = Count > 0 ? FMath::Min(Min, Value) : Value;
+	Max = Count > 0 ? FMath::Max(Max, Value) : Value;
+	Sum += Value;
+	Count++;
+}
+
+void FBucketedHistogram::Remove(float Value)
+{
+	uint32& BucketCount = Counts[FindBucket(Value)];
+	if (BucketCount == 0) return;
+
+	BucketCount--;
+	Sum -= Value;
+	Count--;
+}
+
+void FBucketedHistogram::SetRange(float InMin, float InMax)
+{
+	Min = InMin;
+	Max = InMax;
+}
+
+void FBucketedHistogram::Reset()
+{
+	Counts.Reset();
+	Counts.AddZeroed(UpperBounds.Num() + 1);
+	Count = 0;
+	Sum = 0.0;
+	Min = 0.f;
+	Max = 0.f;
+}
+
+int32 FBucketedHistogram::FindBucket(float Value) const
+{
+	// Few buckets, a linear scan beats a binary search here
+	int32 Bucket = 0;
+	while (Bucket < UpperBounds.Num() && Value > UpperBounds[Bucket])
+	{
+		++Bucket;
+	}
+	return Bucket;
+}
+
+float FBucketedHistogram::GetPercentile(float Fraction) const
+{
+	if (Count == 0) return 0.f;
+
+	const uint32 Target = FMath::Max<uint32>(1, FMath::CeilToInt(Fraction * Count));
+	uint32 Seen = 0;
+	for (int32 Bucket = 0; Bucket < UpperBounds.Num(); ++Bucket)
+	{
+		Seen += Counts[Bucket];
+		if (Seen >= Target)
+		{
+			return UpperBounds[Bucket];
+		}
+	}
+	return Max;
+}
+
+FString FBucketedHistogram::ToString() const
+{
+	return FString::Printf(TEXT("n=%d mean=%.2f p50=%.2f p95=%.2f p99=%.2f max=%.2f"),
+		Count, GetMean(), GetPercentile(0.5f), GetPercentile(0.95f), GetPercentile(0.99f), GetMax());
+}
+
+FString FBucketedHistogram::ToCsvBuckets() const
+{
+	FString Result;
+	for (int32 Bucket = 0; Bucket < Counts.Num(); ++Bucket)
+	{
+		Result += FString::Printf(Bucket == 0 ? TEXT("%u") : TEXT(",%u"), Counts[Bucket]);
+	}
+	return Result;
+}
+
+FString FBucketedHistogram::GetCsvHeader() const
+{
+	FString Result;
+	for (float Bound : UpperBounds)
+	{
+		Result += FString::Printf(TEXT("le_%g,"), Bound);
+	}
+	return Result + TEXT("inf");
+}
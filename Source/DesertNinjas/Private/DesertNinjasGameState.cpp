@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DesertNinjasGameState.h"
+
+#include "Item.h"
+#include "Net/UnrealNetwork.h"
+
+ADesertNinjasGameState::ADesertNinjasGameState()
+{
+	RestoreCount = 0;
+	AppliedRestoreCount = 0;
+}
+
+void ADesertNinjasGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(ADesertNinjasGameState, CollectedItems);
+	DOREPLIFETIME(ADesertNinjasGameState, RestoreCount);
+}
+
+const FCollectibleBitset* ADesertNinjasGameState::FindLevelState(FName LevelName) const
+{
+	for (const FLevelCollectibleState& State : CollectedItems)
+	{
+		if (State.LevelName == LevelName)
+		{
+			return &State.Collected;
+		}
+	}
+	return nullptr;
+}
+
+bool ADesertNinjasGameState::IsItemCollected(const AItem* Item) const
+{
+	if (!Item || Item->ItemIndex == INDEX_NONE) return false;
+
+	const FCollectibleBitset* Collected = FindLevelState(Item->GetCollectionLevelName());
+	return Collected && Collected->Contains(Item->ItemIndex);
+}
+
+void ADesertNinjasGameState::MarkItemCollected(AItem* Item)
+{
+	if (!HasAuthority() || !Item || Item->ItemIndex == INDEX_NONE) return;
+
+	const FName LevelName = Item->GetCollectionLevelName();
+	FLevelCollectibleState* State = CollectedItems.FindByPredicate(
+		[LevelName](const FLevelCollectibleState& Entry) { return Entry.LevelName == LevelName; });
+	if (!State)
+	{
+		State = &CollectedItems.AddDefaulted_GetRef();
+		State->LevelName = LevelName;
+	}
+	State->Collected.Add(Item->ItemIndex);
+}
+
+void ADesertNinjasGameState::RegisterItem(AItem* Item)
+{
+	if (!Item || Item->ItemIndex == INDEX_NONE) return;
+
+	TArray<TWeakObjectPtr<AItem>>& Items = RegisteredItems.FindOrAdd(Item->GetCollectionLevelName());
+	if (Item->ItemIndex >= Items.Num())
+	{
+		Items.SetNum(Item->ItemIndex + 1);
+	}
+	Items[Item->ItemIndex] = Item;
+}
+
+void ADesertNinjasGameState::UnregisterItem(AItem* Item)
+{
+	if (!Item || Item->ItemIndex == INDEX_NONE) return;
+
+	TArray<TWeakObjectPtr<AItem>>* Items = RegisteredItems.Find(Item->GetCollectionLevelName());
+	if (Items && Items->IsValidIndex(Item->ItemIndex) && (*Items)[Item->ItemIndex] == Item)
+	{
+		(*Items)[Item->ItemIndex] = nullptr;
+	}
+}
+
+void ADesertNinjasGameState::RestoreCollectedItems(const TArray<FLevelCollectibleState>& SavedState)
+{
+	if (!HasAuthority()) return;
+
+	CollectedItems = SavedState;
+	++RestoreCount;
+	ApplyCollectedItems(true);
+}
+
+void ADesertNinjasGameState::OnRep_CollectedItems()
+{
+	// Both properties arrive in the same update, a restore comes with a new count
+	ApplyCollectedItems(RestoreCount != AppliedRestoreCount);
+}
+
+void ADesertNinjasGameState::ApplyCollectedItems(bool bRestore)
+{
+	AppliedRestoreCount = RestoreCount;
+
+	for (const TPair<FName, TArray<TWeakObjectPtr<AItem>>>& Level : RegisteredItems)
+	{
+		const FCollectibleBitset* Collected = FindLevelState(Level.Key);
+		for (int32 Index = 0; Index < Level.Value.Num(); ++Index)
+		{
+			AItem* Item = Level.Value[Index].Get();
+			if (!Item) continue;
+
+			const bool bCollected = Collected && Collected->Contains(Index);
+			if (bCollected && !Item->IsHidden())
+			{
+				// Items are kept alive so their level's GC cluster isn't dissolved
+				Item->HideAfterCollection();
+			}
+			else if (!bCollected && bRestore && Item->IsHidden())
+			{
+				// Collected after the checkpoint
+				Item->Reactivate();
+			}
+		}
+	}
+}
@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "DesertNinjasPlayerController.h"
+
+#include "GameFramework/PlayerInput.h"
+#include "InputCoreTypes.h"
+#include "Misc/CommandLine.h"
+
+ADesertNinjasPlayerController::ADesertNinjasPlayerController()
+{
+	BotBehavior = EBotBehavior::BB_None;
+	DecisionInterval = FVector2D(0.5f, 2.f);
+	JumpChance = 0.3f;
+	AttackChance = 0.3f;
+	ThrowChance = 0.1f;
+
+	ScriptStep = 0;
+	MoveDirection = 0.f;
+	TimeToNextDecision = 0.f;
+}
+
+void ADesertNinjasPlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!IsLocalController() || !FParse::Param(FCommandLine::Get(), TEXT("Bot"))) return;
+
+	int32 Seed = 0;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("BotSeed="), Seed))
+	{
+		Seed = (int32)FPlatformTime::Cycles();
+	}
+	Random.Initialize(Seed);
+
+	FString ScriptParam;
+	if (FParse::Value(FCommandLine::Get(), TEXT("BotScript="), ScriptParam, false))
+	{
+		ParseScript(ScriptParam);
+	}
+	BotBehavior = Script.Num() > 0 ? EBotBehavior::BB_Scripted : EBotBehavior::BB_RandomWalk;
+}
+
+void ADesertNinjasPlayerController::ParseScript(const FString& ScriptParam)
+{
+	TArray<FString> Tokens;
+	ScriptParam.ParseIntoArray(Tokens, TEXT(","));
+	for (const FString& Token : Tokens)
+	{
+		if (Token.IsEmpty()) continue;
+
+		FBotStep Step;
+		Step.Action = FChar::ToUpper(Token[0]);
+		Step.Duration = Token.Len() > 1 ? FCString::Atof(*Token.Mid(1)) : 0.f;
+		Script.Add(Step);
+	}
+}
+
+void ADesertNinjasPlayerController::PlayerTick(float DeltaTime)
+{
+	// Inject input before it is processed this frame
+	if (PlayerInput && GetPawn())
+	{
+		// Keys pressed last frame are released now, so held actions like Jump register
+		for (const FKey& Key : PendingReleases)
+		{
+			InputKey(Key, IE_Released, 0.f, Key.IsGamepadKey());
+		}
+		PendingReleases.Reset();
+
+		if (BotBehavior == EBotBehavior::BB_RandomWalk)
+		{
+			TickRandomWalk(DeltaTime);
+		}
+		else if (BotBehavior == EBotBehavior::BB_Scripted)
+		{
+			TickScript(DeltaTime);
+		}
+	}
+
+	Super::PlayerTick(DeltaTime);
+}
+
+void ADesertNinjasPlayerController::TickRandomWalk(float DeltaTime)
+{
+	TimeToNextDecision -= DeltaTime;
+	if (TimeToNextDecision <= 0.f)
+	{
+		TimeToNextDecision = Random.FRandRange(DecisionInterval.X, DecisionInterval.Y);
+
+		// Favor running over standing so bots spread out across the level
+		const float Roll = Random.FRand();
+		MoveDirection = Roll < 0.45f ? 1.f : (Roll < 0.9f ? -1.f : 0.f);
+
+		if (Random.FRand() < JumpChance) TapAction(TEXT("Jump"));
+		if (Random.FRand() < AttackChance) TapAction(TEXT("Attack"));
+		if (Random.FRand() < ThrowChance) TapAction(TEXT("Throw"));
+	}
+
+	InputAxis(EKeys::Gamepad_LeftX, MoveDirection, DeltaTime, 1, true);
+}
+
+void ADesertNinjasPlayerController::TickScript(float DeltaTime)
+{
+	TimeToNextDecision -= DeltaTime;
+	while (TimeToNextDecision <= 0.f)
+	{
+		const FBotStep& Step = Script[ScriptStep];
+		ScriptStep = (ScriptStep + 1) % Script.Num();
+
+		MoveDirection = 0.f;
+		switch (Step.Action)
+		{
+		case 'R': MoveDirection = 1.f; break;
+		case 'L': MoveDirection = -1.f; break;
+		case 'J': TapAction(TEXT("Jump")); break;
+		case 'A': TapAction(TEXT("Attack")); break;
+		case 'T': TapAction(TEXT("Throw")); break;
+		default: break;
+		}
+
+		// Instant actions still take a frame so a script without waits cannot spin forever
+		TimeToNextDecision += FMath::Max(Step.Duration, DeltaTime);
+	}
+
+	InputAxis(EKeys::Gamepad_LeftX, MoveDirection, DeltaTime, 1, true);
+}
+
+void ADesertNinjasPlayerController::TapAction(FName ActionName)
+{
+	const TArray<FInputActionKeyMapping>& Mappings = PlayerInput->GetKeysForAction(ActionName);
+	if (Mappings.Num() == 0) return;
+
+	const FKey Key = Mappings[0].Key;
+	if (PendingReleases.Contains(Key)) return;
+
+	InputKey(Key, IE_Pressed, 1.f, Key.IsGamepadKey());
+	PendingReleases.Add(Key);
+}
@@ -0,0 +1,303 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EndlessRunnerGenerator.h"
+#include "EndlessSegment.h"
+#include "FloatingPlatform.h"
+#include "Item.h"
+#include "MemoryBudget.h"
+
+#include "Async/Async.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/CommandLine.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogEndlessRunner, Log, All);
+
+AEndlessRunnerGenerator::AEndlessRunnerGenerator()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	Seed = 0;
+	GenerateAheadDistance = 8192.f;
+	RecycleBehindDistance = 4096.f;
+	LayoutBatchSize = 8;
+	PrewarmPerSegment = 1;
+
+	LayoutEndX = 0.f;
+	LastLayoutSegment = INDEX_NONE;
+}
+
+void AEndlessRunnerGenerator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!HasAuthority() || Segments.Num() == 0)
+	{
+		SetActorTickEnabled(false);
+		return;
+	}
+
+	int32 RunSeed = Seed;
+	FParse::Value(FCommandLine::Get(), TEXT("EndlessSeed="), RunSeed);
+	while (RunSeed == 0)
+	{
+		RunSeed = FMath::Rand();
+	}
+	LayoutStream.Initialize(RunSeed);
+	UE_LOG(LogEndlessRunner, Log, TEXT("Endless level seed %d"), RunSeed);
+
+	TArray<FEndlessSegmentShape> SegmentShapes;
+	for (const UEndlessSegment* Segment : Segments)
+	{
+		FEndlessSegmentShape& Shape = SegmentShapes.AddDefaulted_GetRef();
+		Shape.Length = Segment ? FMath::Max(Segment->Length, 1.f) : 1.f;
+		Shape.Weight = Segment ? Segment->Weight : 0.f;
+		if (Segment)
+		{
+			for (const FEndlessSegmentElement& Element : Segment->Elements)
+			{
+				Shape.SpawnChances.Add(Element.SpawnChance);
+			}
+		}
+	}
+	Shapes = MakeShared<TArray<FEndlessSegmentShape>, ESPMode::ThreadSafe>(MoveTemp(SegmentShapes));
+
+	Pools.SetNum(Segments.Num());
+	for (int32 SegmentIndex = 0; SegmentIndex < Segments.Num(); ++SegmentIndex)
+	{
+		// Empty slots have no weight and are never placed
+		if (!Segments[SegmentIndex]) continue;
+
+		for (int32 Count = 0; Count < PrewarmPerSegment; ++Count)
+		{
+			Pools[SegmentIndex].Free.Add(SpawnSegment(SegmentIndex));
+		}
+	}
+
+	// The first batch is computed right away so the level is there on the first frame
+	ApplyLayout(ComputeLayout(*Shapes, LayoutStream, LayoutEndX, LastLayoutSegment, LayoutBatchSize));
+}
+
+void AEndlessRunnerGenerator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingLayout.IsValid() && PendingLayout.IsReady())
+	{
+		ApplyLayout(PendingLayout.Get());
+		PendingLayout = TFuture<FEndlessLayoutBatch>();
+	}
+
+	float MinX, MaxX;
+	if (!GetPlayerRange(MinX, MaxX)) return;
+
+	while (ActiveSegments.Num() > 0 && ActiveSegments[0].EndX < MinX - RecycleBehindDistance)
+	{
+		ReleaseSegment(ActiveSegments[0]);
+		ActiveSegments.RemoveAt(0);
+	}
+
+	const float OriginX = GetActorLocation().X;
+	while (Planned.Num() > 0 && OriginX + Planned[0].StartX < MaxX + GenerateAheadDistance)
+	{
+		FEndlessSegmentInstance Instance = AcquireSegment(Planned[0].SegmentIndex);
+		PlaceSegment(Instance, Planned[0]);
+		ActiveSegments.Add(MoveTemp(Instance));
+		Planned.RemoveAt(0);
+	}
+
+	// Stay one batch ahead so placement never waits on the task
+	if (Planned.Num() < LayoutBatchSize && !PendingLayout.IsValid())
+	{
+		StartLayout();
+	}
+}
+
+FEndlessLayoutBatch AEndlessRunnerGenerator::ComputeLayout(const TArray<FEndlessSegmentShape>& SegmentShapes, FRandomStream Stream, float StartX, int32 LastSegmentIndex, int32 Count)
+{
+	FEndlessLayoutBatch Batch;
+	Batch.EndX = StartX;
+	Batch.LastSegmentIndex = LastSegmentIndex;
+
+	float AllWeight = 0.f;
+	for (const FEndlessSegmentShape& Shape : SegmentShapes)
+	{
+		AllWeight += FMath::Max(Shape.Weight, 0.f);
+	}
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		// Don't repeat the previous segment when another one can be picked instead
+		float TotalWeight = AllWeight;
+		int32 Excluded = INDEX_NONE;
+		if (SegmentShapes.IsValidIndex(Batch.LastSegmentIndex))
+		{
+			const float OtherWeight = TotalWeight - FMath::Max(SegmentShapes[Batch.LastSegmentIndex].Weight, 0.f);
+			if (OtherWeight > 0.f)
+			{
+				Excluded = Batch.LastSegmentIndex;
+				TotalWeight = OtherWeight;
+			}
+		}
+		if (TotalWeight <= 0.f) break;
+
+		int32 Picked = INDEX_NONE;
+		float Roll = Stream.FRand() * TotalWeight;
+		for (int32 ShapeIndex = 0; ShapeIndex < SegmentShapes.Num(); ++ShapeIndex)
+		{
+			if (ShapeIndex == Excluded || SegmentShapes[ShapeIndex].Weight <= 0.f) continue;
+
+			Picked = ShapeIndex;
+			Roll -= SegmentShapes[ShapeIndex].Weight;
+			if (Roll < 0.f) break;
+		}
+
+		const FEndlessSegmentShape& Shape = SegmentShapes[Picked];
+		FEndlessSegmentLayout& Layout = Batch.Segments.AddDefaulted_GetRef();
+		Layout.SegmentIndex = Picked;
+		Layout.StartX = Batch.EndX;
+		Layout.EnabledElements.Init(false, Shape.SpawnChances.Num());
+		for (int32 Element = 0; Element < Shape.SpawnChances.Num(); ++Element)
+		{
+			Layout.EnabledElements[Element] = Stream.FRand() < Shape.SpawnChances[Element];
+		}
+
+		Batch.EndX += Shape.Length;
+		Batch.LastSegmentIndex = Picked;
+	}
+
+	Batch.Stream = Stream;
+	return Batch;
+}
+
+void AEndlessRunnerGenerator::StartLayout()
+{
+	PendingLayout = Async(EAsyncExecution::TaskGraph,
+		[SegmentShapes = Shapes, Stream = LayoutStream, StartX = LayoutEndX, LastSegment = LastLayoutSegment, Count = LayoutBatchSize]()
+		{
+			return ComputeLayout(*SegmentShapes, Stream, StartX, LastSegment, Count);
+		});
+}
+
+void AEndlessRunnerGenerator::ApplyLayout(const FEndlessLayoutBatch& Batch)
+{
+	Planned.Append(Batch.Segments);
+	LayoutStream = Batch.Stream;
+	LayoutEndX = Batch.EndX;
+	LastLayoutSegment = Batch.LastSegmentIndex;
+}
+
+FEndlessSegmentInstance AEndlessRunnerGenerator::SpawnSegment(int32 SegmentIndex)
+{
+	DN_LLM_SCOPE(Gameplay);
+
+	FEndlessSegmentInstance Instance;
+	Instance.SegmentIndex = SegmentIndex;
+
+	const UEndlessSegment* Segment = Segments[SegmentIndex];
+	if (!Segment) return Instance;
+
+	// One entry per element, even if it couldn't be spawned, so indices line up with the layout
+	for (const FEndlessSegmentElement& Element : Segment->Elements)
+	{
+		AActor* Actor = Element.ActorClass ? GetWorld()->SpawnActorDeferred<AActor>(Element.ActorClass, GetActorTransform(), this,
+			nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn) : nullptr;
+		if (Actor)
+		{
+			// Relocations aren't replicated, so pooled copies stay local to this machine
+			Actor->SetReplicates(false);
+			Actor->FinishSpawning(GetActorTransform());
+			DeactivateElement(Actor);
+		}
+		Instance.Actors.Add(Actor);
+	}
+	return Instance;
+}
+
+FEndlessSegmentInstance AEndlessRunnerGenerator::AcquireSegment(int32 SegmentIndex)
+{
+	TArray<FEndlessSegmentInstance>& Free = Pools[SegmentIndex].Free;
+	return Free.Num() > 0 ? Free.Pop(false) : SpawnSegment(SegmentIndex);
+}
+
+void AEndlessRunnerGenerator::PlaceSegment(FEndlessSegmentInstance& Instance, const FEndlessSegmentLayout& Layout)
+{
+	const UEndlessSegment* Segment = Segments[Layout.SegmentIndex];
+	if (!Segment) return;
+
+	const FTransform SegmentTransform(GetActorLocation() + FVector(Layout.StartX, 0.f, 0.f));
+
+	Instance.StartX = SegmentTransform.GetLocation().X;
+	Instance.EndX = Instance.StartX + Segment->Length;
+
+	for (int32 Element = 0; Element < Instance.Actors.Num(); ++Element)
+	{
+		AActor* Actor = Instance.Actors[Element];
+		if (!Actor || !Layout.EnabledElements[Element]) continue;
+
+		Actor->SetActorTransform(Segment->Elements[Element].RelativeTransform * SegmentTransform, false, nullptr, ETeleportType::TeleportPhysics);
+		ActivateElement(Actor);
+	}
+}
+
+void AEndlessRunnerGenerator::ReleaseSegment(FEndlessSegmentInstance& Instance)
+{
+	for (AActor* Actor : Instance.Actors)
+	{
+		if (Actor)
+		{
+			DeactivateElement(Actor);
+		}
+	}
+	Pools[Instance.SegmentIndex].Free.Add(MoveTemp(Instance));
+}
+
+void AEndlessRunnerGenerator::ActivateElement(AActor* Actor)
+{
+	if (AItem* Item = Cast<AItem>(Actor))
+	{
+		Item->Reactivate();
+		return;
+	}
+
+	Actor->SetActorHiddenInGame(false);
+	Actor->SetActorEnableCollision(true);
+	Actor->SetActorTickEnabled(Actor->PrimaryActorTick.bStartWithTickEnabled);
+
+	if (AFloatingPlatform* Platform = Cast<AFloatingPlatform>(Actor))
+	{
+		Platform->RestartPath(Platform->GetActorLocation());
+	}
+}
+
+void AEndlessRunnerGenerator::DeactivateElement(AActor* Actor)
+{
+	if (AItem* Item = Cast<AItem>(Actor))
+	{
+		Item->HideAfterCollection();
+		return;
+	}
+
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorTickEnabled(false);
+}
+
+bool AEndlessRunnerGenerator::GetPlayerRange(float& OutMinX, float& OutMaxX) const
+{
+	bool bFound = false;
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		const APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+		if (!Pawn) continue;
+
+		const float X = Pawn->GetActorLocation().X;
+		OutMinX = bFound ? FMath::Min(OutMinX, X) : X;
+		OutMaxX = bFound ? FMath::Max(OutMaxX, X) : X;
+		bFound = true;
+	}
+	return bFound;
+}
@@ -22,30 +22,26 @@ void AExplosive::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor
 
 	UE_LOG(LogTemp, Warning, TEXT("Begin overlap on explosive"));
 
-	if (OtherActor)
+	// Explosives with a definition are handled by the item system
+	if (!Definition && OtherActor && HasAuthority())
 	{
 		ADesertNinjasCharacter* Main = Cast<ADesertNinjasCharacter>(OtherActor);
 		/*AEnemy* Enemy = Cast<AEnemy>(OtherActor);*/
 		if (Main)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("Fire on explosive bp"));
-			OnExplosionBP(Main);
-			if (OverlapParticles)
-			{
-				UGameplayStatics::SpawnEmitterAtLocation(GetWorld(),
-					OverlapParticles, GetActorLocation(), FRotator(0.f), true);
-			}
-			if (OverlapSound)
-			{
-				UGameplayStatics::PlaySound2D(this, OverlapSound);
-			}
 			UGameplayStatics::ApplyDamage(OtherActor, Damage, nullptr, this, DamageTypeClass);
 
-			Destroy();
+			Collect(Main);
 		}
 	}
 }
 
+void AExplosive::PlayCollectedEvents(ADesertNinjasCharacter* Collector)
+{
+	UE_LOG(LogTemp, Warning, TEXT("Fire on explosive bp"));
+	OnExplosionBP(Collector);
+}
+
 void AExplosive::OnOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
 	Super::OnOverlapEnd(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex);
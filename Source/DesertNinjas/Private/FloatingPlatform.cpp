@@ -4,18 +4,30 @@
 #include "../Source/DesertNinjas/Public/FloatingPlatform.h"
 
 #include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
 #include "TimerManager.h"
+#include "SideScrollerRelevancy.h"
+#include "MemoryBudget.h"
 
 
 // Sets default values
 AFloatingPlatform::AFloatingPlatform()
 {
+	DN_LLM_SCOPE(Platforms);
+
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
 	Mesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Mesh"));
 	RootComponent = Mesh;
 
+	// Moves as a kinematic body: riders are carried through their movement base, nothing needs overlaps
+	Mesh->SetMobility(EComponentMobility::Movable);
+	Mesh->SetGenerateOverlapEvents(false);
+	Mesh->SetCanEverAffectNavigation(false);
+
 	StartPoint = FVector(0.f);
 	EndPoint = FVector(0.f);
 
@@ -23,6 +35,22 @@ AFloatingPlatform::AFloatingPlatform()
 
 	InterpSpeed = 4.0f;
 	InterpTime = 1.f;
+
+	// The path is sent once, after that every machine computes the location from time
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+	NetRelevancyHalfWidth = 4096.f;
+
+	bPathReceived = false;
+	TravelTime = 0.f;
+	bLegacyMovement = false;
+}
+
+void AFloatingPlatform::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(AFloatingPlatform, Path, COND_InitialOnly);
 }
 
 // Called when the game starts or when spawned
@@ -35,9 +63,91 @@ void AFloatingPlatform::BeginPlay()
 
 	bInterping = false;
 
-	GetWorldTimerManager().SetTimer(InterpTimer, this, &AFloatingPlatform::ToggleInterping, InterpTime);
-
 	Distance = (EndPoint - StartPoint).Size();
+
+	if (bLegacyMovement)
+	{
+		Mesh->ComponentVelocity = FVector::ZeroVector;
+		GetWorldTimerManager().SetTimer(LegacyInterpTimer, this, &AFloatingPlatform::ToggleLegacyInterping, InterpTime);
+		return;
+	}
+
+	// Clients use their own copy of the level until the server's start time arrives
+	if (HasAuthority() || !bPathReceived)
+	{
+		Path.StartPoint = StartPoint;
+		Path.EndPoint = EndPoint;
+		Path.InterpSpeed = InterpSpeed;
+		Path.InterpTime = InterpTime;
+		Path.StartTime = GetPathTime();
+		UpdatePathTiming();
+	}
+
+	if (HasAuthority())
+	{
+		// Replicates the path once, then the platform is dormant again
+		FlushNetDormancy();
+	}
+}
+
+void AFloatingPlatform::RestartPath(const FVector& NewStartPoint)
+{
+	const FVector Offset = NewStartPoint - StartPoint;
+	StartPoint += Offset;
+	EndPoint += Offset;
+
+	Path.StartPoint = StartPoint;
+	Path.EndPoint = EndPoint;
+	Path.StartTime = GetPathTime();
+	SetActorLocation(StartPoint, false, nullptr, ETeleportType::TeleportPhysics);
+
+	if (HasAuthority())
+	{
+		FlushNetDormancy();
+	}
+}
+
+void AFloatingPlatform::OnRep_Path()
+{
+	bPathReceived = true;
+	UpdatePathTiming();
+}
+
+void AFloatingPlatform::UpdatePathTiming()
+{
+	const float PathDistance = (Path.EndPoint - Path.StartPoint).Size();
+	TravelTime = (PathDistance > 1.f && Path.InterpSpeed > 0.f) ? FMath::Loge(PathDistance) / Path.InterpSpeed : 0.f;
+}
+
+float AFloatingPlatform::GetPathTime() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
+FVector AFloatingPlatform::EvaluatePath(float Time, FVector& OutVelocity)
+{
+	OutVelocity = FVector::ZeroVector;
+
+	// Each leg waits InterpTime, then eases towards the far end point
+	const float LegTime = Path.InterpTime + TravelTime;
+	if (LegTime <= 0.f) return Path.StartPoint;
+
+	const float Elapsed = FMath::Max(Time - Path.StartTime, 0.f);
+	const int32 Leg = FMath::FloorToInt(Elapsed / LegTime);
+	const float MoveTime = Elapsed - Leg * LegTime - Path.InterpTime;
+
+	const bool bForward = (Leg % 2) == 0;
+	const FVector& From = bForward ? Path.StartPoint : Path.EndPoint;
+	const FVector& To = bForward ? Path.EndPoint : Path.StartPoint;
+
+	bInterping = MoveTime > 0.f;
+	if (!bInterping) return From;
+
+	// VInterpTo covers a fixed fraction of the remaining distance per second
+	const FVector Remaining = (From - To) * FMath::Exp(-Path.InterpSpeed * MoveTime);
+	OutVelocity = -Path.InterpSpeed * Remaining;
+	return To + Remaining;
 }
 
 // Called every frame
@@ -45,31 +155,44 @@ void AFloatingPlatform::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	if (bInterping)
+	if (bLegacyMovement)
+	{
+		TickLegacyMovement(DeltaTime);
+		return;
+	}
+
+	FVector Velocity;
+	const FVector Location = EvaluatePath(GetPathTime(), Velocity);
+
+	// Riders jumping off inherit the base velocity
+	Mesh->ComponentVelocity = Velocity;
+	if (!Location.Equals(GetActorLocation()))
+	{
+		SetActorLocation(Location);
+	}
+}
+
+void AFloatingPlatform::TickLegacyMovement(float DeltaTime)
+{
+	if (!bInterping) return;
+
+	SetActorLocation(FMath::VInterpTo(GetActorLocation(), EndPoint, DeltaTime, InterpSpeed));
+
+	const float DistanceTraveled = (GetActorLocation() - StartPoint).Size();
+	if (Distance - DistanceTraveled <= 1.f)
 	{
-		FVector CurrentLocation = GetActorLocation();
-		FVector Interp = FMath::VInterpTo(CurrentLocation, EndPoint, DeltaTime, InterpSpeed);
-		SetActorLocation(Interp);
-
-		float DistanceTraveled = (GetActorLocation() - StartPoint).Size();
-		if (Distance - DistanceTraveled <= 1.f)
-		{
-			ToggleInterping();
-
-			GetWorldTimerManager().SetTimer(InterpTimer, this, &AFloatingPlatform::ToggleInterping, InterpTime);
-			SwapVectors(StartPoint, EndPoint);
-		}
+		ToggleLegacyInterping();
+		GetWorldTimerManager().SetTimer(LegacyInterpTimer, this, &AFloatingPlatform::ToggleLegacyInterping, InterpTime);
+		Swap(StartPoint, EndPoint);
 	}
 }
 
-void AFloatingPlatform::ToggleInterping()
+void AFloatingPlatform::ToggleLegacyInterping()
 {
 	bInterping = !bInterping;
 }
 
-void AFloatingPlatform::SwapVectors(FVector& VecOne, FVector& VecTwo)
+bool AFloatingPlatform::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
 {
-	FVector Temp = VecOne;
-	VecOne = VecTwo;
-	VecTwo = Temp;
+	return SideScrollerRelevancy::IsRelevant(this, SrcLocation, NetRelevancyHalfWidth);
 }
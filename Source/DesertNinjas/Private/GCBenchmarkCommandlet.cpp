@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GCBenchmarkCommandlet.h"
+#include "HeadlessWorld.h"
+#include "ItemCluster.h"
+#include "Pickup.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGCBenchmark, Log, All);
+
+namespace
+{
+	struct FGCTimings
+	{
+		double MinMs = TNumericLimits<double>::Max();
+		double MaxMs = 0.0;
+		double TotalMs = 0.0;
+		int32 Passes = 0;
+
+		double AvgMs() const { return Passes > 0 ? TotalMs / Passes : 0.0; }
+	};
+
+	FGCTimings TimeGarbageCollection(int32 Passes)
+	{
+		// Warm up so the first measured pass doesn't pay for earlier garbage
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+
+		FGCTimings Timings;
+		for (int32 Pass = 0; Pass < Passes; ++Pass)
+		{
+			const double Start = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+			const double Ms = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+			Timings.MinMs = FMath::Min(Timings.MinMs, Ms);
+			Timings.MaxMs = FMath::Max(Timings.MaxMs, Ms);
+			Timings.TotalMs += Ms;
+			Timings.Passes++;
+		}
+		return Timings;
+	}
+}
+
+UGCBenchmarkCommandlet::UGCBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UGCBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 Count = 10000;
+	int32 Passes = 5;
+	FParse::Value(*Params, TEXT("Count="), Count);
+	FParse::Value(*Params, TEXT("Passes="), Passes);
+
+	UClass* ItemClass = APickup::StaticClass();
+	FString ItemClassPath;
+	if (FParse::Value(*Params, TEXT("ItemClass="), ItemClassPath))
+	{
+		ItemClass = LoadClass<AItem>(nullptr, *ItemClassPath);
+		if (!ItemClass)
+		{
+			UE_LOG(LogGCBenchmark, Error, TEXT("Could not load item class %s"), *ItemClassPath);
+			return 1;
+		}
+	}
+
+	FScopedHeadlessWorld Headless(TEXT("GCBenchmark"));
+
+	TArray<AItem*> Items;
+	Items.Reserve(Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FVector Location(Index * 100.f, 0.f, 0.f);
+		Items.Add(Headless.World->SpawnActor<AItem>(ItemClass, Location, FRotator::ZeroRotator));
+	}
+
+	const FGCTimings Unclustered = TimeGarbageCollection(Passes);
+
+	UItemCluster* Cluster = UItemCluster::Create(Headless.World->PersistentLevel, Items);
+	Cluster->AddToRoot();
+
+	// Shows the cluster with its object count, next to any level clusters
+	if (FParse::Param(*Params, TEXT("ListClusters")))
+	{
+		IConsoleManager::Get().ProcessUserConsoleInput(TEXT("gc.ListClusters"), *GLog, Headless.World);
+	}
+
+	const FGCTimings Clustered = TimeGarbageCollection(Passes);
+	const int32 NumClustered = Cluster->GetNumClusteredItems();
+
+	Cluster->RemoveFromRoot();
+
+	UE_LOG(LogGCBenchmark, Display, TEXT("GCBenchmark items=%d clustered_items=%d objects=%d passes=%d"),
+		Count, NumClustered, GUObjectArray.GetObjectArrayNumMinusAvailable(), Passes);
+	UE_LOG(LogGCBenchmark, Display, TEXT("  unclustered min_ms=%.2f avg_ms=%.2f max_ms=%.2f"), Unclustered.MinMs, Unclustered.AvgMs(), Unclustered.MaxMs);
+	UE_LOG(LogGCBenchmark, Display, TEXT("  clustered   min_ms=%.2f avg_ms=%.2f max_ms=%.2f"), Clustered.MinMs, Clustered.AvgMs(), Clustered.MaxMs);
+
+	return 0;
+}
@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayScheduler.h"
+
+#include "DesertNinjas.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Gameplay Scheduler Dispatch"), STAT_GameplaySchedulerDispatch, STATGROUP_DesertNinjas);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gameplay Timers Fired"), STAT_GameplayTimersFired, STATGROUP_DesertNinjas);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Gameplay Timers Pending"), STAT_GameplayTimersPending, STATGROUP_DesertNinjas);
+
+UGameplayScheduler::UGameplayScheduler()
+{
+	TickResolution = 1.f / 60.f;
+}
+
+UGameplayScheduler* UGameplayScheduler::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	return World ? World->GetSubsystem<UGameplayScheduler>() : nullptr;
+}
+
+void UGameplayScheduler::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Wheel = FGameplayTimingWheel(FMath::Max(TickResolution, 0.001f));
+}
+
+bool UGameplayScheduler::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->IsGameWorld() && !IsTemplate();
+}
+
+TStatId UGameplayScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGameplayScheduler, STATGROUP_Tickables);
+}
+
+void UGameplayScheduler::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_GameplaySchedulerDispatch);
+
+	// World time so pausing and time dilation apply to gameplay timers too
+	const int32 NumFired = Wheel.Advance(GetWorld()->GetTimeSeconds());
+
+	INC_DWORD_STAT_BY(STAT_GameplayTimersFired, NumFired);
+	SET_DWORD_STAT(STAT_GameplayTimersPending, Wheel.Num());
+}
+
+void UGameplayScheduler::SetTimer(FGameplayTimerHandle& InOutHandle, FSimpleDelegate Callback, float Delay, bool bLoop)
+{
+	Wheel.Remove(InOutHandle);
+	InOutHandle = Wheel.Add(Delay, MoveTemp(Callback), bLoop);
+}
+
+void UGameplayScheduler::ClearTimer(FGameplayTimerHandle& Handle)
+{
+	Wheel.Remove(Handle);
+}
+
+bool UGameplayScheduler::IsTimerActive(const FGameplayTimerHandle& Handle) const
+{
+	return Wheel.IsPending(Handle);
+}
+
+float UGameplayScheduler::GetTimerRemaining(const FGameplayTimerHandle& Handle) const
+{
+	return (float)Wheel.GetRemaining(Handle);
+}
@@ -0,0 +1,225 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GameplayTimingWheel.h"
+#include "MemoryBudget.h"
+
+FGameplayTimingWheel::FGameplayTimingWheel(double InTickInterval)
+	: TickInterval(InTickInterval)
+{
+	check(TickInterval > 0.0);
+	for (int32& Head : Heads)
+	{
+		Head = INDEX_NONE;
+	}
+}
+
+int64 FGameplayTimingWheel::ToTicks(double Seconds) const
+{
+	// Never fire in the slot currently being processed
+	return FMath::Max<int64>(1, (int64)FMath::CeilToDouble(Seconds / TickInterval));
+}
+
+FGameplayTimerHandle FGameplayTimingWheel::Add(double Delay, FSimpleDelegate Callback, bool bLoop)
+{
+	int32 NodeIndex = FreeHead;
+	if (NodeIndex != INDEX_NONE)
+	{
+		FreeHead = Nodes[NodeIndex].Next;
+	}
+	else
+	{
+		DN_LLM_SCOPE(Gameplay);
+		NodeIndex = Nodes.AddDefaulted();
+	}
+
+	FNode& Node = Nodes[NodeIndex];
+	const int64 DelayTicks = ToTicks(Delay);
+	Node.Callback = MoveTemp(Callback);
+	Node.ExpireTick = CurrentTick + DelayTicks;
+	Node.IntervalTicks = bLoop ? DelayTicks : 0;
+	Insert(NodeIndex);
+	++NumPending;
+
+	FGameplayTimerHandle Handle;
+	Handle.Index = NodeIndex;
+	Handle.Serial = Node.Serial;
+	return Handle;
+}
+
+bool FGameplayTimingWheel::IsValidHandle(const FGameplayTimerHandle& Handle) const
+{
+	return Nodes.IsValidIndex(Handle.Index)
+		&& Nodes[Handle.Index].Serial == Handle.Serial
+		&& Nodes[Handle.Index].List != NoList;
+}
+
+bool FGameplayTimingWheel::Remove(FGameplayTimerHandle& Handle)
+{
+	const bool bPending = IsValidHandle(Handle);
+	if (bPending)
+	{
+		Unlink(Handle.Index);
+		Release(Handle.Index);
+	}
+	Handle.Invalidate();
+	return bPending;
+}
+
+bool FGameplayTimingWheel::IsPending(const FGameplayTimerHandle& Handle) const
+{
+	return IsValidHandle(Handle);
+}
+
+double FGameplayTimingWheel::GetRemaining(const FGameplayTimerHandle& Handle) const
+{
+	if (!IsValidHandle(Handle)) return -1.0;
+
+	return (Nodes[Handle.Index].ExpireTick - CurrentTick) * TickInterval;
+}
+
+void FGameplayTimingWheel::Link(int32 NodeIndex, int32 List)
+{
+	FNode& Node = Nodes[NodeIndex];
+	Node.List = List;
+	Node.Prev = INDEX_NONE;
+	Node.Next = Heads[List];
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = NodeIndex;
+	}
+	Heads[List] = NodeIndex;
+}
+
+void FGameplayTimingWheel::Unlink(int32 NodeIndex)
+{
+	FNode& Node = Nodes[NodeIndex];
+	if (Node.Prev != INDEX_NONE)
+	{
+		Nodes[Node.Prev].Next = Node.Next;
+	}
+	else
+	{
+		Heads[Node.List] = Node.Next;
+	}
+	if (Node.Next != INDEX_NONE)
+	{
+		Nodes[Node.Next].Prev = Node.Prev;
+	}
+	Node.Prev = INDEX_NONE;
+	Node.Next = INDEX_NONE;
+	Node.List = NoList;
+}
+
+void FGameplayTimingWheel::Insert(int32 NodeIndex)
+{
+	const FNode& Node = Nodes[NodeIndex];
+	const int64 MaxDelta = (1LL << (SlotBits * NumLevels)) - 1;
+
+	// Timers beyond the last level park in its furthest slot and are re-inserted when it cascades
+	const int64 Delta = FMath::Clamp<int64>(Node.ExpireTick - CurrentTick, 0, MaxDelta);
+	const int64 SlotTick = CurrentTick + Delta;
+
+	int32 Level = 0;
+	while (Level < NumLevels - 1 && Delta >= (1LL << (SlotBits * (Level + 1))))
+	{
+		++Level;
+	}
+
+	const int32 Slot = (int32)((SlotTick >> (SlotBits * Level)) & (SlotsPerLevel - 1));
+	Link(NodeIndex, Level * SlotsPerLevel + Slot);
+}
+
+void FGameplayTimingWheel::Release(int32 NodeIndex)
+{
+	FNode& Node = Nodes[NodeIndex];
+	Node.Callback.Unbind();
+	++Node.Serial;
+	if (Node.Serial == 0)
+	{
+		Node.Serial = 1;
+	}
+	Node.Next = FreeHead;
+	FreeHead = NodeIndex;
+	--NumPending;
+}
+
+void FGameplayTimingWheel::Cascade(int32 Level)
+{
+	const int32 Slot = (int32)((CurrentTick >> (SlotBits * Level)) & (SlotsPerLevel - 1));
+	const int32 List = Level * SlotsPerLevel + Slot;
+
+	int32 NodeIndex = Heads[List];
+	Heads[List] = INDEX_NONE;
+	while (NodeIndex != INDEX_NONE)
+	{
+		const int32 Next = Nodes[NodeIndex].Next;
+		Insert(NodeIndex);
+		NodeIndex = Next;
+	}
+}
+
+int32 FGameplayTimingWheel::FireSlot(int32 Slot)
+{
+	if (Heads[Slot] == INDEX_NONE) return 0;
+
+	// Move the slot to the firing list; Unlink keeps working if a callback cancels one of them
+	Heads[FiringList] = Heads[Slot];
+	Heads[Slot] = INDEX_NONE;
+	for (int32 NodeIndex = Heads[FiringList]; NodeIndex != INDEX_NONE; NodeIndex = Nodes[NodeIndex].Next)
+	{
+		Nodes[NodeIndex].List = FiringList;
+	}
+
+	int32 NumFired = 0;
+	while (Heads[FiringList] != INDEX_NONE)
+	{
+		const int32 NodeIndex = Heads[FiringList];
+		Unlink(NodeIndex);
+
+		// The node array may grow while the callback runs
+		FNode& Node = Nodes[NodeIndex];
+		FSimpleDelegate Callback = Node.Callback;
+		if (Node.IntervalTicks > 0 && Callback.IsBound())
+		{
+			Node.ExpireTick = CurrentTick + Node.IntervalTicks;
+			Insert(NodeIndex);
+		}
+		else
+		{
+			Release(NodeIndex);
+		}
+
+		Callback.ExecuteIfBound();
+		++NumFired;
+	}
+	return NumFired;
+}
+
+int32 FGameplayTimingWheel::Advance(double Time)
+{
+	const int64 TargetTick = (int64)FMath::FloorToDouble(Time / TickInterval);
+
+	// Nothing to fire, jump straight to the target
+	if (NumPending == 0)
+	{
+		CurrentTick = FMath::Max(CurrentTick, TargetTick);
+		return 0;
+	}
+
+	int32 NumFired = 0;
+	while (CurrentTick < TargetTick)
+	{
+		++CurrentTick;
+
+		// A lower level wrapped around, pull the next slot of each higher level down
+		for (int32 Level = 1; Level < NumLevels; ++Level)
+		{
+			if ((CurrentTick & ((1LL << (SlotBits * Level)) - 1)) != 0) break;
+			Cascade(Level);
+		}
+
+		NumFired += FireSlot((int32)(CurrentTick & (SlotsPerLevel - 1)));
+	}
+	return NumFired;
+}
@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HeadlessWorld.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+FScopedHeadlessWorld::FScopedHeadlessWorld(FName Name)
+{
+	World = UWorld::CreateWorld(EWorldType::Game, false, Name);
+	World->AddToRoot();
+
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+}
+
+FScopedHeadlessWorld::~FScopedHeadlessWorld()
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitchMonitor.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogHitchMonitor, Log, All);
+
+namespace
+{
+	TAutoConsoleVariable<float> CVarHitchThresholdMs(
+		TEXT("DesertNinjas.HitchThresholdMs"),
+		50.f,
+		TEXT("Game or render thread time above which a frame counts as a hitch and a trace is written to Saved/Hitches. 0 disables."));
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice HitchReportCommand(
+		TEXT("DesertNinjas.HitchReport"),
+		TEXT("Prints the rolling frame time histograms. 'dump' also writes a trace of the recent frames."),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+			[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+			{
+				UHitchMonitor* Monitor = UHitchMonitor::Get(World);
+				if (!Monitor) return;
+
+				Monitor->Report(Ar);
+				if (Args.Num() > 0 && Args[0] == TEXT("dump"))
+				{
+					Ar.Logf(TEXT("Wrote %s"), *Monitor->DumpTrace(TEXT("manual")));
+				}
+			}));
+}
+
+UHitchMonitor* UHitchMonitor::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull);
+	return World ? World->GetSubsystem<UHitchMonitor>() : nullptr;
+}
+
+void UHitchMonitor::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UWorld* World = GetWorld();
+	if (!World || !World->IsGameWorld()) return;
+
+	// Both index into the frame ring, which needs at least one frame
+	WindowFrames = FMath::Max(WindowFrames, 1);
+	TraceFrames = FMath::Max(TraceFrames, 1);
+	Frames.SetNum(FMath::Max(WindowFrames, TraceFrames));
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UHitchMonitor::OnWorldTickStart);
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UHitchMonitor::OnEndFrame);
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UHitchMonitor::OnActorSpawned));
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UHitchMonitor::OnPreGarbageCollect);
+}
+
+void UHitchMonitor::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+
+	Super::Deinitialize();
+}
+
+void UHitchMonitor::OnActorSpawned(AActor* Actor)
+{
+	++Current.ActorSpawns;
+}
+
+void UHitchMonitor::OnPreGarbageCollect()
+{
+	Current.bGarbageCollected = true;
+}
+
+const FHitchFrame& UHitchMonitor::GetFrame(int32 FramesAgo) const
+{
+	return Frames[(NextFrame - 1 - FramesAgo + Frames.Num()) % Frames.Num()];
+}
+
+void UHitchMonitor::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		// Counts from frames this world skipped belong to no frame
+		Current = FHitchFrame();
+		TickStartCycles = FPlatformTime::Cycles();
+	}
+}
+
+void UHitchMonitor::UpdateWindowRange()
+{
+	const FHitchFrame& Newest = GetFrame(0);
+	float GameMin = Newest.GameThreadMs, GameMax = Newest.GameThreadMs;
+	float RenderMin = Newest.RenderThreadMs, RenderMax = Newest.RenderThreadMs;
+	for (int32 FramesAgo = 1; FramesAgo < FMath::Min(NumFrames, WindowFrames); ++FramesAgo)
+	{
+		const FHitchFrame& Frame = GetFrame(FramesAgo);
+		GameMin = FMath::Min(GameMin, Frame.GameThreadMs);
+		GameMax = FMath::Max(GameMax, Frame.GameThreadMs);
+		RenderMin = FMath::Min(RenderMin, Frame.RenderThreadMs);
+		RenderMax = FMath::Max(RenderMax, Frame.RenderThreadMs);
+	}
+	GameThreadMs.SetRange(GameMin, GameMax);
+	RenderThreadMs.SetRange(RenderMin, RenderMax);
+}
+
+void UHitchMonitor::OnEndFrame()
+{
+	// Frames this world didn't tick in, e.g. while loading, aren't gameplay frames
+	if (TickStartCycles == 0) return;
+
+	Current.FrameNumber = GFrameCounter;
+	Current.FrameMs = (float)(FApp::GetDeltaTime() * 1000.0);
+	Current.GameThreadMs = (float)FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - TickStartCycles);
+	Current.RenderThreadMs = FApp::CanEverRender() ? (float)FPlatformTime::ToMilliseconds(GRenderThreadTime) : 0.f;
+	Current.ActiveItems = ActiveItems;
+	TickStartCycles = 0;
+
+	// The window slides, the oldest frame leaves the histograms
+	bool bRemovedExtreme = false;
+	if (NumFrames >= WindowFrames)
+	{
+		const FHitchFrame& Oldest = GetFrame(WindowFrames - 1);
+		bRemovedExtreme =
+			Oldest.GameThreadMs >= GameThreadMs.GetMax() || Oldest.GameThreadMs <= GameThreadMs.GetMin() ||
+			Oldest.RenderThreadMs >= RenderThreadMs.GetMax() || Oldest.RenderThreadMs <= RenderThreadMs.GetMin();
+		GameThreadMs.Remove(Oldest.GameThreadMs);
+		RenderThreadMs.Remove(Oldest.RenderThreadMs);
+	}
+	GameThreadMs.Add(Current.GameThreadMs);
+	RenderThreadMs.Add(Current.RenderThreadMs);
+
+	Frames[NextFrame] = Current;
+	NextFrame = (NextFrame + 1) % Frames.Num();
+	NumFrames = FMath::Min(NumFrames + 1, Frames.Num());
+
+	if (bRemovedExtreme)
+	{
+		UpdateWindowRange();
+	}
+
+	const float ThresholdMs = CVarHitchThresholdMs.GetValueOnGameThread();
+	const float WorstMs = FMath::Max(Current.GameThreadMs, Current.RenderThreadMs);
+	if (ThresholdMs > 0.f && WorstMs > ThresholdMs && FPlatformTime::Seconds() - LastTraceTime > MinSecondsBetweenTraces)
+	{
+		LastTraceTime = FPlatformTime::Seconds();
+		const FString Filename = DumpTrace(*FString::Printf(TEXT("%.1f ms over %.1f ms"), WorstMs, ThresholdMs));
+		UE_LOG(LogHitchMonitor, Warning, TEXT("Hitch in frame %llu: game %.1f ms, render %.1f ms, trace in %s"),
+			Current.FrameNumber, Current.GameThreadMs, Current.RenderThreadMs, *Filename);
+	}
+
+	Current = FHitchFrame();
+}
+
+void UHitchMonitor::Report(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("Last %d frames"), FMath::Min(NumFrames, WindowFrames));
+	Ar.Logf(TEXT("  game thread   %s"), *GameThreadMs.ToString());
+	Ar.Logf(TEXT("  render thread %s"), *RenderThreadMs.ToString());
+}
+
+FString UHitchMonitor::DumpTrace(const TCHAR* Reason)
+{
+	FString Trace = FString::Printf(TEXT("# %s, map %s, reason: %s\n# game thread %s\n# render thread %s\n"),
+		*FDateTime::Now().ToString(), *GetWorld()->GetMapName(), Reason, *GameThreadMs.ToString(), *RenderThreadMs.ToString());
+	Trace += TEXT("frame,frame_ms,game_ms,render_ms,gc,active_items,spawns,overlaps,emitters\n");
+
+	for (int32 FramesAgo = FMath::Min(NumFrames, TraceFrames) - 1; FramesAgo >= 0; --FramesAgo)
+	{
+		const FHitchFrame& Frame = GetFrame(FramesAgo);
+		Trace += FString::Printf(TEXT("%llu,%.2f,%.2f,%.2f,%d,%d,%d,%d,%d\n"),
+			Frame.FrameNumber, Frame.FrameMs, Frame.GameThreadMs, Frame.RenderThreadMs, Frame.bGarbageCollected ? 1 : 0,
+			Frame.ActiveItems, Frame.ActorSpawns, Frame.ItemOverlaps, Frame.EmitterSpawns);
+	}
+
+	const FString Filename = FPaths::ProjectSavedDir() / TEXT("Hitches") / FString::Printf(TEXT("%s-%s-%llu.csv"),
+		*GetWorld()->GetMapName(), *FDateTime::Now().ToString(), GFrameCounter);
+	if (!FFileHelper::SaveStringToFile(Trace, *Filename))
+	{
+		UE_LOG(LogHitchMonitor, Warning, TEXT("Could not write %s"), *Filename);
+	}
+	return Filename;
+}
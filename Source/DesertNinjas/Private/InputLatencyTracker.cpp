@@ -0,0 +1,223 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InputLatencyTracker.h"
+#include "DesertNinjas.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogInputLatency, Log, All);
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Jump input to apply (ms)"), STAT_JumpInputToApply, STATGROUP_DesertNinjas);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Jump input to flipbook (ms)"), STAT_JumpInputToFlipbook, STATGROUP_DesertNinjas);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Attack input to apply (ms)"), STAT_AttackInputToApply, STATGROUP_DesertNinjas);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Attack input to flipbook (ms)"), STAT_AttackInputToFlipbook, STATGROUP_DesertNinjas);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Throw input to apply (ms)"), STAT_ThrowInputToApply, STATGROUP_DesertNinjas);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Throw input to flipbook (ms)"), STAT_ThrowInputToFlipbook, STATGROUP_DesertNinjas);
+
+namespace
+{
+	TAutoConsoleVariable<int32> CVarLowLatencyInput(
+		TEXT("DesertNinjas.LowLatencyInput"),
+		0,
+		TEXT("1: attacks and throws change state and flipbook inside the input handler\n")
+		TEXT("0: they are picked up by the next animation update (default)"));
+
+	const TCHAR* ActionNames[] = { TEXT("Jump"), TEXT("Attack"), TEXT("Throw") };
+	const TCHAR* StageNames[] = { TEXT("Applied"), TEXT("Flipbook") };
+
+	FString GetCsvFilename(const UWorld* World)
+	{
+		return FPaths::ProfilingDir() / TEXT("InputLatency") / FString::Printf(TEXT("%s-%s.csv"), *World->GetMapName(), *FDateTime::Now().ToString());
+	}
+
+	void SetLatencyStat(EInputLatencyAction Action, EInputLatencyStage Stage, float Ms)
+	{
+		const bool bFlipbook = Stage == EInputLatencyStage::Flipbook;
+		switch (Action)
+		{
+		case EInputLatencyAction::Jump:
+			if (bFlipbook) { SET_FLOAT_STAT(STAT_JumpInputToFlipbook, Ms); } else { SET_FLOAT_STAT(STAT_JumpInputToApply, Ms); }
+			break;
+		case EInputLatencyAction::Attack:
+			if (bFlipbook) { SET_FLOAT_STAT(STAT_AttackInputToFlipbook, Ms); } else { SET_FLOAT_STAT(STAT_AttackInputToApply, Ms); }
+			break;
+		case EInputLatencyAction::Throw:
+			if (bFlipbook) { SET_FLOAT_STAT(STAT_ThrowInputToFlipbook, Ms); } else { SET_FLOAT_STAT(STAT_ThrowInputToApply, Ms); }
+			break;
+		default:
+			break;
+		}
+	}
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice InputLatencyCommand(
+		TEXT("DesertNinjas.InputLatency"),
+		TEXT("Prints input latency histograms per action. 'reset' clears them, 'csv' writes them to Saved/Profiling/InputLatency"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+			[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+			{
+				UInputLatencyTracker* Tracker = UInputLatencyTracker::Get(World);
+				if (!Tracker) return;
+
+				if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+				{
+					Tracker->Reset();
+				}
+				else if (Args.Num() > 0 && Args[0] == TEXT("csv"))
+				{
+					Tracker->WriteCsv(GetCsvFilename(World));
+				}
+				else
+				{
+					Tracker->Report(Ar);
+				}
+			}));
+}
+
+UInputLatencyTracker* UInputLatencyTracker::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UInputLatencyTracker>() : nullptr;
+}
+
+bool UInputLatencyTracker::IsLowLatencyEnabled()
+{
+	return CVarLowLatencyInput.GetValueOnGameThread() != 0;
+}
+
+void UInputLatencyTracker::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	EndFrameHandle = FCoreDelegates::OnEndFrame.AddUObject(this, &UInputLatencyTracker::OnEndFrame);
+}
+
+void UInputLatencyTracker::Deinitialize()
+{
+	FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+
+	if (GetWorld()->IsGameWorld() && FParse::Param(FCommandLine::Get(), TEXT("InputLatencyCsv")))
+	{
+		WriteCsv(GetCsvFilename(GetWorld()));
+	}
+
+	Super::Deinitialize();
+}
+
+void UInputLatencyTracker::MarkInput(const UObject* Source, EInputLatencyAction Action)
+{
+	// Real time on both ends, FApp time is simulated under fixed timestep and benchmark runs
+	FPendingInput& Input = Pending.FindOrAdd(FObjectKey(Source)).Actions[(int32)Action];
+	Input = FPendingInput();
+	Input.InputTime = FPlatformTime::Seconds();
+	Input.InputFrame = GFrameCounter;
+	Input.bActive = true;
+}
+
+void UInputLatencyTracker::MarkStage(const UObject* Source, EInputLatencyAction Action, EInputLatencyStage Stage)
+{
+	// Setting the flipbook shows nothing yet, it is on screen with the frame it was set in
+	if (Stage == EInputLatencyStage::Flipbook)
+	{
+		FlipbookMarks.Emplace(FObjectKey(Source), Action);
+		return;
+	}
+	RecordStage(FObjectKey(Source), Action, Stage);
+}
+
+void UInputLatencyTracker::OnEndFrame()
+{
+	for (const TPair<FObjectKey, EInputLatencyAction>& Mark : FlipbookMarks)
+	{
+		RecordStage(Mark.Key, Mark.Value, EInputLatencyStage::Flipbook);
+	}
+	FlipbookMarks.Reset();
+}
+
+void UInputLatencyTracker::RecordStage(const FObjectKey& Source, EInputLatencyAction Action, EInputLatencyStage Stage)
+{
+	FPendingInputs* Inputs = Pending.Find(Source);
+	if (!Inputs) return;
+
+	FPendingInput& Input = Inputs->Actions[(int32)Action];
+	if (!Input.bActive || Input.bStageDone[(int32)Stage]) return;
+
+	Input.bStageDone[(int32)Stage] = true;
+
+	const float Ms = (float)((FPlatformTime::Seconds() - Input.InputTime) * 1000.0);
+	FLatencyResults& Result = Results[(int32)Action][(int32)Stage];
+	Result.Milliseconds.Add(Ms);
+	Result.TotalFrames += GFrameCounter - Input.InputFrame;
+	SetLatencyStat(Action, Stage, Ms);
+
+	bool bAllDone = true;
+	for (bool bDone : Input.bStageDone)
+	{
+		bAllDone &= bDone;
+	}
+	Input.bActive = !bAllDone;
+}
+
+void UInputLatencyTracker::Report(FOutputDevice& Ar) const
+{
+	for (int32 Action = 0; Action < (int32)EInputLatencyAction::Count; ++Action)
+	{
+		for (int32 Stage = 0; Stage < (int32)EInputLatencyStage::Count; ++Stage)
+		{
+			const FLatencyResults& Result = Results[Action][Stage];
+			const int32 Num = Result.Milliseconds.Num();
+			Ar.Logf(TEXT("%-6s %-8s %s ms, %.2f frames"), ActionNames[Action], StageNames[Stage],
+				*Result.Milliseconds.ToString(), Num > 0 ? (double)Result.TotalFrames / Num : 0.0);
+		}
+	}
+}
+
+void UInputLatencyTracker::Reset()
+{
+	Pending.Reset();
+	FlipbookMarks.Reset();
+	for (auto& ActionResults : Results)
+	{
+		for (FLatencyResults& Result : ActionResults)
+		{
+			Result.Milliseconds.Reset();
+			Result.TotalFrames = 0;
+		}
+	}
+}
+
+bool UInputLatencyTracker::WriteCsv(const FString& Filename) const
+{
+	FString Csv = TEXT("action,stage,low_latency,count,mean_ms,p50_ms,p95_ms,p99_ms,max_ms,mean_frames,")
+		+ Results[0][0].Milliseconds.GetCsvHeader() + TEXT("\n");
+
+	for (int32 Action = 0; Action < (int32)EInputLatencyAction::Count; ++Action)
+	{
+		for (int32 Stage = 0; Stage < (int32)EInputLatencyStage::Count; ++Stage)
+		{
+			const FLatencyResults& Result = Results[Action][Stage];
+			const FBucketedHistogram& Histogram = Result.Milliseconds;
+			const int32 Num = Histogram.Num();
+			Csv += FString::Printf(TEXT("%s,%s,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%s\n"),
+				ActionNames[Action], StageNames[Stage], IsLowLatencyEnabled() ? 1 : 0, Num,
+				Histogram.GetMean(), Histogram.GetPercentile(0.5f), Histogram.GetPercentile(0.95f),
+				Histogram.GetPercentile(0.99f), Histogram.GetMax(),
+				Num > 0 ? (double)Result.TotalFrames / Num : 0.0,
+				*Histogram.ToCsvBuckets());
+		}
+	}
+
+	if (!FFileHelper::SaveStringToFile(Csv, *Filename))
+	{
+		UE_LOG(LogInputLatency, Warning, TEXT("Could not write %s"), *Filename);
+		return false;
+	}
+	UE_LOG(LogInputLatency, Log, TEXT("Wrote input latency to %s"), *Filename);
+	return true;
+}
@@ -3,10 +3,79 @@
 #include "Components/StaticMeshComponent.h"
 #include "Components/BoxComponent.h"
 #include "Particles/ParticleSystemComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "Sound/SoundCue.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "DesertNinjas.h"
+#include "DesertNinjasGameState.h"
+#include "SplitscreenCameraDirector.h"
+#include "SideScrollerRelevancy.h"
+#include "MemoryBudget.h"
+#include "GameplayScheduler.h"
+#include "ItemDefinition.h"
+#include "ItemSystem.h"
+#include "HitchMonitor.h"
+
+#if WITH_EDITOR
+namespace
+{
+	/** Gives every item in the level a unique index. Existing indices are never renumbered so
+		saved collection state stays valid; duplicates and new items are appended after the
+		highest index rather than reusing slots of deleted items, whose bits may still be saved. */
+	void AssignLevelItemIndices(ULevel* Level)
+	{
+		// Every item in the level is saved together, only index once per save
+		static TWeakObjectPtr<ULevel> LastLevel;
+		static uint64 LastFrame = 0;
+		if (LastLevel.Get() == Level && LastFrame == GFrameCounter) return;
+		LastLevel = Level;
+		LastFrame = GFrameCounter;
+
+		TArray<AItem*> Items;
+		int32 MaxIndex = INDEX_NONE;
+		for (AActor* Actor : Level->Actors)
+		{
+			AItem* Item = Cast<AItem>(Actor);
+			if (Item && !Item->IsPendingKill())
+			{
+				Items.Add(Item);
+				MaxIndex = FMath::Max(MaxIndex, Item->ItemIndex);
+			}
+		}
+
+		// Sort by name so index collisions are resolved the same way on every save
+		Items.Sort([](const AItem& A, const AItem& B) { return A.GetFName().LexicalLess(B.GetFName()); });
+
+		TBitArray<> Used(false, MaxIndex + 1);
+		TArray<AItem*> Unassigned;
+		for (AItem* Item : Items)
+		{
+			const int32 Index = Item->ItemIndex;
+			if (Index >= 0 && !Used[Index])
+			{
+				Used[Index] = true;
+			}
+			else
+			{
+				Unassigned.Add(Item);
+			}
+		}
+
+		int32 NextIndex = MaxIndex + 1;
+		for (AItem* Item : Unassigned)
+		{
+			Item->ItemIndex = NextIndex++;
+		}
+	}
+}
+#endif
 
 // Sets default values
 AItem::AItem()
 {
+	DN_LLM_SCOPE(Items);
+
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -22,6 +91,18 @@ AItem::AItem()
 	bRotate = false;
 	RotationRate = 45.f;
 
+	ItemIndex = INDEX_NONE;
+	RotatingItemIndex = INDEX_NONE;
+	Definition = nullptr;
+	bCountedActive = false;
+
+	// Level items live as long as their level, let them share its GC cluster
+	bCanBeInCluster = true;
+
+	// Items don't change until collected, so they stay dormant until then
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
+	NetRelevancyHalfWidth = 4096.f;
 }
 
 // Called when the game starts or when spawned
@@ -29,9 +110,70 @@ void AItem::BeginPlay()
 {
 	Super::BeginPlay();
 
-	CollisionVolume->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnOverlapBegin);
-	CollisionVolume->OnComponentEndOverlap.AddDynamic(this, &AItem::OnOverlapEnd);
+	if (Definition)
+	{
+		// Only character capsules respond to Collectible, and only the server resolves overlaps.
+		// The item system binds to the volume itself while the item is active.
+		CollisionVolume->SetCollisionObjectType(ECC_Collectible);
+		CollisionVolume->SetCollisionResponseToAllChannels(ECR_Ignore);
+		CollisionVolume->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+		CollisionVolume->SetGenerateOverlapEvents(HasAuthority());
+	}
+	else
+	{
+		CollisionVolume->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnOverlapBegin);
+		CollisionVolume->OnComponentEndOverlap.AddDynamic(this, &AItem::OnOverlapEnd);
+	}
+
+	ADesertNinjasGameState* GameState = GetWorld()->GetGameState<ADesertNinjasGameState>();
+	if (GameState)
+	{
+		// Registered even when collected, restoring an earlier checkpoint brings it back
+		GameState->RegisterItem(this);
 
+		// Skip items that were collected before we joined or before the checkpoint
+		if (GameState->IsItemCollected(this))
+		{
+			HideAfterCollection();
+			return;
+		}
+	}
+	SetCountedActive(true);
+
+	if (Definition)
+	{
+		// The item system rotates defined items, they never tick on their own
+		SetActorTickEnabled(false);
+		if (UItemSystem* ItemSystem = UItemSystem::Get(this))
+		{
+			ItemSystem->RegisterItem(this);
+		}
+	}
+	else if (USplitscreenCameraDirector* CameraDirector = GetWorld()->GetSubsystem<USplitscreenCameraDirector>())
+	{
+		// Idle rotation is cosmetic, no need to tick while off screen
+		CameraDirector->RegisterCullable(this);
+	}
+}
+
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ADesertNinjasGameState* GameState = GetWorld()->GetGameState<ADesertNinjasGameState>();
+	if (GameState)
+	{
+		GameState->UnregisterItem(this);
+	}
+	if (USplitscreenCameraDirector* CameraDirector = GetWorld()->GetSubsystem<USplitscreenCameraDirector>())
+	{
+		CameraDirector->UnregisterCullable(this);
+	}
+	if (UItemSystem* ItemSystem = GetWorld()->GetSubsystem<UItemSystem>())
+	{
+		ItemSystem->UnregisterItem(this);
+	}
+	SetCountedActive(false);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -47,9 +189,32 @@ void AItem::Tick(float DeltaTime)
 	}
 }
 
-void AItem::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AItem::OnConstruction(const FTransform& Transform)
 {
+	Super::OnConstruction(Transform);
+
+	if (!Definition) return;
 
+	if (Definition->Mesh)
+	{
+		Mesh->SetStaticMesh(Definition->Mesh);
+	}
+	if (Definition->IdleParticles)
+	{
+		IdleParticlesComponent->SetTemplate(Definition->IdleParticles);
+	}
+	OverlapParticles = Definition->OverlapParticles;
+	OverlapSound = Definition->OverlapSound;
+	bRotate = Definition->bRotate;
+	RotationRate = Definition->RotationRate;
+}
+
+void AItem::OnOverlapBegin(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (UHitchMonitor* Monitor = UHitchMonitor::Get(this))
+	{
+		Monitor->CountItemOverlap();
+	}
 }
 
 void AItem::OnOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
@@ -57,3 +222,150 @@ void AItem::OnOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* Other
 
 }
 
+FName AItem::GetCollectionLevelName() const
+{
+	const ULevel* Level = GetLevel();
+	return Level ? FName(*UWorld::RemovePIEPrefix(Level->GetOutermost()->GetName())) : NAME_None;
+}
+
+void AItem::MarkCollected()
+{
+	ADesertNinjasGameState* GameState = GetWorld()->GetGameState<ADesertNinjasGameState>();
+	if (GameState)
+	{
+		GameState->MarkItemCollected(this);
+	}
+}
+
+void AItem::PreSave(const ITargetPlatform* TargetPlatform)
+{
+	Super::PreSave(TargetPlatform);
+
+#if WITH_EDITOR
+	ULevel* Level = GetLevel();
+	if (Level && !IsTemplate() && !(GetWorld() && GetWorld()->IsGameWorld()))
+	{
+		AssignLevelItemIndices(Level);
+	}
+#endif
+}
+
+void AItem::Collect(ADesertNinjasCharacter* Collector)
+{
+	if (!HasAuthority()) return;
+
+	MarkCollected();
+	HideAfterCollection();
+
+	// Wake the item so the hidden state and multicast go out, then give them time to arrive
+	FlushNetDormancy();
+	MulticastCollected(Collector);
+	if (UGameplayScheduler* Scheduler = UGameplayScheduler::Get(this))
+	{
+		Scheduler->SetTimer(DormancyTimer, this, &AItem::GoDormant, 1.f);
+	}
+}
+
+void AItem::GoDormant()
+{
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AItem::MulticastCollected_Implementation(ADesertNinjasCharacter* Collector)
+{
+	// The collector may not be relevant to this client
+	if (Collector)
+	{
+		OnItemCollectedBP(Collector);
+		PlayCollectedEvents(Collector);
+	}
+
+	if (OverlapParticles)
+	{
+		DN_LLM_SCOPE(Effects);
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), OverlapParticles,
+			GetActorLocation(), FRotator(0.f), true, EPSCPoolMethod::AutoRelease);
+
+		if (UHitchMonitor* Monitor = UHitchMonitor::Get(this))
+		{
+			Monitor->CountEmitterSpawn();
+		}
+	}
+	if (OverlapSound)
+	{
+		UGameplayStatics::PlaySound2D(this, OverlapSound);
+	}
+
+	HideAfterCollection();
+}
+
+void AItem::HideAfterCollection()
+{
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	IdleParticlesComponent->DeactivateSystem();
+
+	// Keep the camera director and item system from waking it up again
+	if (USplitscreenCameraDirector* CameraDirector = GetWorld()->GetSubsystem<USplitscreenCameraDirector>())
+	{
+		CameraDirector->UnregisterCullable(this);
+	}
+	if (UItemSystem* ItemSystem = GetWorld()->GetSubsystem<UItemSystem>())
+	{
+		ItemSystem->UnregisterItem(this);
+	}
+	SetCountedActive(false);
+}
+
+void AItem::Reactivate()
+{
+	if (UGameplayScheduler* Scheduler = UGameplayScheduler::Get(this))
+	{
+		Scheduler->ClearTimer(DormancyTimer);
+	}
+
+	SetActorHiddenInGame(false);
+	IdleParticlesComponent->ActivateSystem();
+	SetCountedActive(true);
+
+	if (Definition)
+	{
+		// Register first so the item system hears overlaps that begin as soon as collision is back on
+		if (UItemSystem* ItemSystem = GetWorld()->GetSubsystem<UItemSystem>())
+		{
+			ItemSystem->RegisterItem(this);
+		}
+	}
+	else if (USplitscreenCameraDirector* CameraDirector = GetWorld()->GetSubsystem<USplitscreenCameraDirector>())
+	{
+		// The director turns tick back on once the item is in view
+		CameraDirector->RegisterCullable(this);
+	}
+	else
+	{
+		SetActorTickEnabled(PrimaryActorTick.bStartWithTickEnabled);
+	}
+	SetActorEnableCollision(true);
+
+	if (HasAuthority())
+	{
+		FlushNetDormancy();
+	}
+}
+
+void AItem::SetCountedActive(bool bActive)
+{
+	if (bCountedActive == bActive) return;
+
+	bCountedActive = bActive;
+	if (UHitchMonitor* Monitor = UHitchMonitor::Get(this))
+	{
+		Monitor->AddActiveItems(bActive ? 1 : -1);
+	}
+}
+
+bool AItem::IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const
+{
+	return SideScrollerRelevancy::IsRelevant(this, SrcLocation, NetRelevancyHalfWidth);
+}
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemCluster.h"
+#include "Item.h"
+#include "UObject/UObjectArray.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogItemCluster, Log, All);
+
+UItemCluster* UItemCluster::Create(UObject* Outer, const TArray<AItem*>& InItems)
+{
+	UItemCluster* Cluster = NewObject<UItemCluster>(Outer, NAME_None, RF_Transient);
+	Cluster->Items = InItems;
+	Cluster->CreateCluster();
+
+	// Items already in another cluster, or rooted, are only kept as mutable references
+	const int32 NumClustered = Cluster->GetNumClusteredItems();
+	if (NumClustered < InItems.Num())
+	{
+		UE_LOG(LogItemCluster, Warning, TEXT("Only %d of %d items joined cluster %s"), NumClustered, InItems.Num(), *Cluster->GetName());
+	}
+	return Cluster;
+}
+
+int32 UItemCluster::GetNumClusteredItems() const
+{
+	const int32 RootIndex = GUObjectArray.ObjectToIndex(this);
+	int32 NumClustered = 0;
+	for (const AItem* Item : Items)
+	{
+		const FUObjectItem* ObjectItem = Item ? GUObjectArray.ObjectToObjectItem(Item) : nullptr;
+		if (ObjectItem && ObjectItem->GetOwnerIndex() == RootIndex)
+		{
+			++NumClustered;
+		}
+	}
+	return NumClustered;
+}
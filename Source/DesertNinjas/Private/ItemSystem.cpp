@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemSystem.h"
+#include "DesertNinjas.h"
+#include "DesertNinjasCharacter.h"
+#include "HitchMonitor.h"
+#include "Item.h"
+#include "SplitscreenCameraDirector.h"
+
+#include "Components/SphereComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item System"), STAT_ItemSystem, STATGROUP_DesertNinjas);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Overlaps"), STAT_ItemOverlaps, STATGROUP_DesertNinjas);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Rotating Items"), STAT_RotatingItems, STATGROUP_DesertNinjas);
+
+UItemSystem* UItemSystem::Get(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	return World ? World->GetSubsystem<UItemSystem>() : nullptr;
+}
+
+bool UItemSystem::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->IsGameWorld() && !IsTemplate();
+}
+
+TStatId UItemSystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemSystem, STATGROUP_Tickables);
+}
+
+void UItemSystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ItemSystem);
+
+	for (int32 Effect = 0; Effect < (int32)EItemEffect::EIE_MAX; ++Effect)
+	{
+		if (PendingOverlaps[Effect].Num() > 0)
+		{
+			// Collecting unregisters the items, which edits the pending lists
+			TArray<FItemOverlap> Overlaps = MoveTemp(PendingOverlaps[Effect]);
+			PendingOverlaps[Effect].Reset();
+
+			INC_DWORD_STAT_BY(STAT_ItemOverlaps, Overlaps.Num());
+			ProcessOverlaps((EItemEffect)Effect, Overlaps);
+		}
+	}
+
+	RotateItems(DeltaTime);
+}
+
+void UItemSystem::RegisterItem(AItem* Item)
+{
+	if (!Item || !Item->Definition) return;
+
+	// Items without an effect are never collected
+	if (Item->HasAuthority() && Item->Definition->Effect != EItemEffect::EIE_None)
+	{
+		Item->CollisionVolume->OnComponentBeginOverlap.AddUniqueDynamic(this, &UItemSystem::OnItemOverlap);
+	}
+
+	if (Item->bRotate && Item->RotatingItemIndex == INDEX_NONE)
+	{
+		Item->RotatingItemIndex = RotatingItems.Add(Item);
+		RotationRates.Add(Item->RotationRate);
+		INC_DWORD_STAT(STAT_RotatingItems);
+	}
+}
+
+void UItemSystem::UnregisterItem(AItem* Item)
+{
+	if (!Item) return;
+
+	Item->CollisionVolume->OnComponentBeginOverlap.RemoveDynamic(this, &UItemSystem::OnItemOverlap);
+
+	const int32 Index = Item->RotatingItemIndex;
+	if (Index != INDEX_NONE)
+	{
+		RotatingItems.RemoveAtSwap(Index);
+		RotationRates.RemoveAtSwap(Index);
+		Item->RotatingItemIndex = INDEX_NONE;
+		if (RotatingItems.IsValidIndex(Index) && RotatingItems[Index])
+		{
+			RotatingItems[Index]->RotatingItemIndex = Index;
+		}
+		DEC_DWORD_STAT(STAT_RotatingItems);
+	}
+
+	for (TArray<FItemOverlap>& Overlaps : PendingOverlaps)
+	{
+		Overlaps.RemoveAllSwap([Item](const FItemOverlap& Overlap) { return Overlap.Item == Item; });
+	}
+}
+
+void UItemSystem::UnregisterCharacter(ADesertNinjasCharacter* Character)
+{
+	for (TArray<FItemOverlap>& Overlaps : PendingOverlaps)
+	{
+		Overlaps.RemoveAllSwap([Character](const FItemOverlap& Overlap) { return Overlap.Character == Character; });
+	}
+}
+
+void UItemSystem::OnItemOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (UHitchMonitor* Monitor = UHitchMonitor::Get(this))
+	{
+		Monitor->CountItemOverlap();
+	}
+
+	// Only registered items bind this, and only characters overlap them
+	AItem* Item = static_cast<AItem*>(OverlappedComponent->GetOwner());
+	checkSlow(Item->IsA<AItem>() && OtherActor->IsA<ADesertNinjasCharacter>());
+
+	const UItemDefinition* Definition = Item->Definition;
+	PendingOverlaps[(int32)Definition->Effect].Add({ Item, static_cast<ADesertNinjasCharacter*>(OtherActor), Definition->Amount });
+}
+
+void UItemSystem::ProcessOverlaps(EItemEffect Effect, TArray<FItemOverlap>& Overlaps)
+{
+	// Two characters can touch the same item in one frame, the first one gets it
+	Overlaps.RemoveAll([](const FItemOverlap& Overlap) { return Overlap.Item->IsHidden(); });
+	for (int32 Index = 0; Index < Overlaps.Num(); ++Index)
+	{
+		for (int32 Other = Index + 1; Other < Overlaps.Num(); ++Other)
+		{
+			if (Overlaps[Other].Item == Overlaps[Index].Item)
+			{
+				Overlaps.RemoveAt(Other--);
+			}
+		}
+	}
+
+	switch (Effect)
+	{
+	case EItemEffect::EIE_Coins:
+		for (const FItemOverlap& Overlap : Overlaps)
+		{
+			Overlap.Character->IncrementCoins((int32)Overlap.Amount);
+			Overlap.Character->PickupLocations.Add(Overlap.Item->GetActorLocation());
+		}
+		break;
+	case EItemEffect::EIE_Health:
+		for (const FItemOverlap& Overlap : Overlaps)
+		{
+			Overlap.Character->IncrementHealth(Overlap.Amount);
+		}
+		break;
+	case EItemEffect::EIE_Damage:
+		for (const FItemOverlap& Overlap : Overlaps)
+		{
+			UGameplayStatics::ApplyDamage(Overlap.Character, Overlap.Amount, nullptr, Overlap.Item, Overlap.Item->Definition->DamageTypeClass);
+		}
+		break;
+	default:
+		break;
+	}
+
+	for (const FItemOverlap& Overlap : Overlaps)
+	{
+		Overlap.Item->Collect(Overlap.Character);
+	}
+}
+
+void UItemSystem::RotateItems(float DeltaTime)
+{
+	const USplitscreenCameraDirector* CameraDirector = GetWorld()->GetSubsystem<USplitscreenCameraDirector>();
+
+	for (int32 Index = 0; Index < RotatingItems.Num(); ++Index)
+	{
+		AItem* Item = RotatingItems[Index];
+		if (!Item) continue;
+
+		const float X = Item->GetActorLocation().X;
+		if (CameraDirector && !CameraDirector->IsRangeVisible(X - CullMargin, X + CullMargin)) continue;
+
+		FRotator Rotation = Item->GetActorRotation();
+		Rotation.Yaw += DeltaTime * RotationRates[Index];
+		Item->SetActorRotation(Rotation);
+	}
+}
@@ -0,0 +1,237 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MapFootprintCommandlet.h"
+
+#if WITH_EDITOR
+#include "AssetRegistryModule.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Sound/SoundWave.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectHash.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogMapFootprint, Log, All);
+
+UMapFootprintCommandlet::UMapFootprintCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+#if WITH_EDITOR
+namespace
+{
+	const TCHAR* MapsPath = TEXT("/Game/Maps");
+
+	struct FMapFootprint
+	{
+		FString Map;
+		TSet<FName> Packages;
+		int64 DiskBytes = 0;
+		int64 UniqueDiskBytes = 0;
+		int64 ResidentBytes = 0;
+		int64 ProcessBytes = 0;
+		double LoadMs = 0.0;
+	};
+
+	double ToMB(int64 Bytes)
+	{
+		return Bytes / (1024.0 * 1024.0);
+	}
+
+	bool SaveAsset(UObject* Asset)
+	{
+		UPackage* Package = Asset->GetOutermost();
+		const FString Filename = FPackageName::LongPackageNameToFilename(Package->GetName(), FPackageName::GetAssetPackageExtension());
+		return UPackage::SavePackage(Package, Asset, RF_Public | RF_Standalone, *Filename);
+	}
+
+	/** Every content package the map hard references, directly or not, including itself */
+	void GatherDependencies(IAssetRegistry& AssetRegistry, FName PackageName, TSet<FName>& OutPackages)
+	{
+		TArray<FName> Stack;
+		Stack.Add(PackageName);
+		while (Stack.Num() > 0)
+		{
+			const FName Name = Stack.Pop(false);
+			bool bAlreadyGathered = false;
+			OutPackages.Add(Name, &bAlreadyGathered);
+			if (bAlreadyGathered) continue;
+
+			TArray<FName> Dependencies;
+			AssetRegistry.GetDependencies(Name, Dependencies, EAssetRegistryDependencyType::Hard);
+			for (FName Dependency : Dependencies)
+			{
+				if (!FPackageName::IsScriptPackage(Dependency.ToString()))
+				{
+					Stack.Add(Dependency);
+				}
+			}
+		}
+	}
+
+	int64 GetDiskSize(IAssetRegistry& AssetRegistry, FName PackageName)
+	{
+		const FAssetPackageData* PackageData = AssetRegistry.GetAssetPackageData(PackageName);
+		return PackageData ? PackageData->DiskSize : 0;
+	}
+
+	/** Long music and ambience is streamed from disk instead of being fully loaded with the map */
+	int32 MarkLongSoundsForStreaming(IAssetRegistry& AssetRegistry, float MinDuration, bool bSave)
+	{
+		TArray<FAssetData> Assets;
+		AssetRegistry.GetAssetsByClass(USoundWave::StaticClass()->GetFName(), Assets, true);
+
+		int32 NumMarked = 0;
+		for (const FAssetData& AssetData : Assets)
+		{
+			USoundWave* Wave = Cast<USoundWave>(AssetData.GetAsset());
+			if (!Wave || Wave->bStreaming || Wave->Duration < MinDuration) continue;
+
+			UE_LOG(LogMapFootprint, Display, TEXT("%s %s (%.1f s)"), bSave ? TEXT("Streaming") : TEXT("Should stream"), *Wave->GetPathName(), Wave->Duration);
+			++NumMarked;
+			if (!bSave) continue;
+
+			Wave->Modify();
+			Wave->bStreaming = true;
+			Wave->PostEditChange();
+			if (!SaveAsset(Wave))
+			{
+				UE_LOG(LogMapFootprint, Warning, TEXT("Could not save %s"), *Wave->GetPathName());
+			}
+		}
+		return NumMarked;
+	}
+
+	bool MeasureMap(IAssetRegistry& AssetRegistry, FMapFootprint& Footprint)
+	{
+		// Start from a clean slate so nothing from the previous map is counted
+		CollectGarbage(RF_NoFlags);
+
+		GatherDependencies(AssetRegistry, FName(*Footprint.Map), Footprint.Packages);
+		for (FName PackageName : Footprint.Packages)
+		{
+			Footprint.DiskBytes += GetDiskSize(AssetRegistry, PackageName);
+		}
+
+		const uint64 UsedBefore = FPlatformMemory::GetStats().UsedPhysical;
+		const double Start = FPlatformTime::Seconds();
+		UPackage* Package = LoadPackage(nullptr, *Footprint.Map, LOAD_None);
+		Footprint.LoadMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+		Footprint.ProcessBytes = (int64)FPlatformMemory::GetStats().UsedPhysical - (int64)UsedBefore;
+
+		if (!Package || !UWorld::FindWorldInPackage(Package))
+		{
+			UE_LOG(LogMapFootprint, Error, TEXT("Could not load map %s"), *Footprint.Map);
+			return false;
+		}
+
+		for (FName PackageName : Footprint.Packages)
+		{
+			UPackage* Loaded = FindPackage(nullptr, *PackageName.ToString());
+			if (!Loaded) continue;
+
+			ForEachObjectWithOuter(Loaded, [&Footprint](UObject* Object)
+			{
+				Footprint.ResidentBytes += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+			}, true);
+		}
+		return true;
+	}
+}
+#endif
+
+int32 UMapFootprintCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	float StreamAudioOver = 10.f;
+	FParse::Value(*Params, TEXT("StreamAudioOver="), StreamAudioOver);
+	// Reporting only unless asked to, marking saves the sound assets
+	const bool bFixStreaming = FParse::Param(*Params, TEXT("FixStreaming"));
+
+	const int32 NumStreamed = MarkLongSoundsForStreaming(AssetRegistry, StreamAudioOver, bFixStreaming);
+	UE_LOG(LogMapFootprint, Display, TEXT("%d sound wave(s) over %.0f s %s"), NumStreamed, StreamAudioOver,
+		bFixStreaming ? TEXT("marked for streaming") : TEXT("not streamed, rerun with -FixStreaming to mark them"));
+
+	TArray<FString> Maps;
+	FString MapParam;
+	if (FParse::Value(*Params, TEXT("Map="), MapParam))
+	{
+		MapParam.ParseIntoArray(Maps, TEXT("+"));
+	}
+	else
+	{
+		TArray<FAssetData> MapAssets;
+		AssetRegistry.GetAssetsByPath(FName(MapsPath), MapAssets, true);
+		for (const FAssetData& AssetData : MapAssets)
+		{
+			if (AssetData.AssetClass == UWorld::StaticClass()->GetFName())
+			{
+				Maps.Add(AssetData.PackageName.ToString());
+			}
+		}
+	}
+
+	TArray<FMapFootprint> Footprints;
+	for (const FString& Map : Maps)
+	{
+		FMapFootprint& Footprint = Footprints.AddDefaulted_GetRef();
+		Footprint.Map = Map;
+		if (!MeasureMap(AssetRegistry, Footprint))
+		{
+			return 1;
+		}
+	}
+
+	// Packages used by a single map only need to ship with that map's chunk
+	TMap<FName, int32> MapsPerPackage;
+	for (const FMapFootprint& Footprint : Footprints)
+	{
+		for (FName PackageName : Footprint.Packages)
+		{
+			MapsPerPackage.FindOrAdd(PackageName)++;
+		}
+	}
+	for (FMapFootprint& Footprint : Footprints)
+	{
+		for (FName PackageName : Footprint.Packages)
+		{
+			if (MapsPerPackage[PackageName] == 1)
+			{
+				Footprint.UniqueDiskBytes += GetDiskSize(AssetRegistry, PackageName);
+			}
+		}
+	}
+
+	FString Csv = TEXT("map,packages,disk_mb,unique_disk_mb,load_ms,resident_mb,process_delta_mb\n");
+	for (const FMapFootprint& Footprint : Footprints)
+	{
+		const FString Row = FString::Printf(TEXT("%s,%d,%.2f,%.2f,%.1f,%.2f,%.2f"),
+			*Footprint.Map, Footprint.Packages.Num(), ToMB(Footprint.DiskBytes), ToMB(Footprint.UniqueDiskBytes),
+			Footprint.LoadMs, ToMB(Footprint.ResidentBytes), ToMB(Footprint.ProcessBytes));
+		UE_LOG(LogMapFootprint, Display, TEXT("%s"), *Row);
+		Csv += Row + TEXT("\n");
+	}
+
+	FString CsvPath = FPaths::ProfilingDir() / TEXT("MapFootprint.csv");
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		UE_LOG(LogMapFootprint, Error, TEXT("Could not write %s"), *CsvPath);
+		return 1;
+	}
+	UE_LOG(LogMapFootprint, Display, TEXT("Wrote %s"), *CsvPath);
+#endif
+	return 0;
+}
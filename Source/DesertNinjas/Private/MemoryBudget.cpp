@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MemoryBudget.h"
+
+#include "DesertNinjasCharacter.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "Stats/Stats.h"
+#include "UObject/UObjectIterator.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMemoryBudget, Log, All);
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+DECLARE_LLM_MEMORY_STAT(TEXT("Items"), STAT_ItemsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Characters"), STAT_CharactersLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Effects"), STAT_EffectsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Platforms"), STAT_PlatformsLLM, STATGROUP_LLMFULL);
+DECLARE_LLM_MEMORY_STAT(TEXT("Gameplay"), STAT_GameplayLLM, STATGROUP_LLMFULL);
+#endif
+
+namespace
+{
+	struct FLLMTagInfo
+	{
+		EDesertNinjasLLMTag Tag;
+		const TCHAR* Name;
+	};
+
+	const FLLMTagInfo LLMTags[] =
+	{
+		{ EDesertNinjasLLMTag::Items, TEXT("Items") },
+		{ EDesertNinjasLLMTag::Characters, TEXT("Characters") },
+		{ EDesertNinjasLLMTag::Effects, TEXT("Effects") },
+		{ EDesertNinjasLLMTag::Platforms, TEXT("Platforms") },
+		{ EDesertNinjasLLMTag::Gameplay, TEXT("Gameplay") },
+	};
+
+	const TCHAR* LLMBudgetPrefix = TEXT("LLM.");
+
+	FAutoConsoleCommandWithWorldArgsAndOutputDevice MemReportCommand(
+		TEXT("DesertNinjas.MemReport"),
+		TEXT("Lists instance counts and bytes per gameplay class and LLM tag, flagging exceeded budgets"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+			[](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+			{
+				TArray<FMemoryReportRow> Rows;
+				DesertNinjasMemory::BuildReport(World, Rows);
+				DesertNinjasMemory::PrintReport(Rows, Ar);
+			}));
+}
+
+bool FMemoryReportRow::IsOverBudget() const
+{
+	if (!Budget) return false;
+
+	return (Budget->MaxCount > 0 && Count > Budget->MaxCount)
+		|| (Budget->MaxMB > 0.f && Bytes > (int64)(Budget->MaxMB * 1024.f * 1024.f));
+}
+
+void DesertNinjasMemory::RegisterLLMTags()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	FLowLevelMemTracker& Tracker = FLowLevelMemTracker::Get();
+	Tracker.RegisterProjectTag((int32)EDesertNinjasLLMTag::Items, TEXT("Items"), GET_STATFNAME(STAT_ItemsLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)EDesertNinjasLLMTag::Characters, TEXT("Characters"), GET_STATFNAME(STAT_CharactersLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)EDesertNinjasLLMTag::Effects, TEXT("Effects"), GET_STATFNAME(STAT_EffectsLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)EDesertNinjasLLMTag::Platforms, TEXT("Platforms"), GET_STATFNAME(STAT_PlatformsLLM), NAME_None);
+	Tracker.RegisterProjectTag((int32)EDesertNinjasLLMTag::Gameplay, TEXT("Gameplay"), GET_STATFNAME(STAT_GameplayLLM), NAME_None);
+#endif
+}
+
+void DesertNinjasMemory::BuildReport(UWorld* World, TArray<FMemoryReportRow>& OutRows)
+{
+	const UMemoryBudgetSettings* Settings = GetDefault<UMemoryBudgetSettings>();
+
+	for (const FMemoryBudget& Budget : Settings->Budgets)
+	{
+		if (Budget.Name.StartsWith(LLMBudgetPrefix)) continue;
+
+		UClass* Class = FindObject<UClass>(ANY_PACKAGE, *Budget.Name);
+		if (!Class)
+		{
+			UE_LOG(LogMemoryBudget, Warning, TEXT("Budget %s does not name a class"), *Budget.Name);
+			continue;
+		}
+
+		FMemoryReportRow& Row = OutRows.AddDefaulted_GetRef();
+		Row.Name = Budget.Name;
+		Row.Budget = &Budget;
+
+		TArray<UObject*> Objects;
+		GetObjectsOfClass(Class, Objects, true, RF_ClassDefaultObject | RF_ArchetypeObject);
+		for (UObject* Object : Objects)
+		{
+			if (World && Object->GetTypedOuter<UWorld>() != World) continue;
+
+			FArchiveCountMem CountMem(Object);
+			Row.Count++;
+			Row.Bytes += CountMem.GetMax() + Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		}
+	}
+
+	// The pickup history grows for the whole session, report it on its own
+	FMemoryReportRow& PickupRow = OutRows.AddDefaulted_GetRef();
+	PickupRow.Name = TEXT("PickupLocations");
+	for (TObjectIterator<ADesertNinjasCharacter> It; It; ++It)
+	{
+		if (World && It->GetWorld() != World) continue;
+
+		PickupRow.Count += It->PickupLocations.Num();
+		PickupRow.Bytes += It->PickupLocations.GetAllocatedSize();
+	}
+
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (FLowLevelMemTracker::IsEnabled())
+	{
+		for (const FLLMTagInfo& Info : LLMTags)
+		{
+			FMemoryReportRow& Row = OutRows.AddDefaulted_GetRef();
+			Row.Name = FString(LLMBudgetPrefix) + Info.Name;
+			Row.bProcessTotal = true;
+			Row.Bytes = FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, (ELLMTag)Info.Tag);
+			Row.Budget = Settings->Budgets.FindByPredicate([&Row](const FMemoryBudget& Budget) { return Budget.Name == Row.Name; });
+		}
+	}
+#endif
+}
+
+int32 DesertNinjasMemory::PrintReport(const TArray<FMemoryReportRow>& Rows, FOutputDevice& Ar)
+{
+	int32 NumOver = 0;
+	Ar.Logf(TEXT("%-28s %8s %12s %10s %12s"), TEXT("Name"), TEXT("Count"), TEXT("KB"), TEXT("MaxCount"), TEXT("MaxKB"));
+	for (const FMemoryReportRow& Row : Rows)
+	{
+		const bool bOver = Row.IsOverBudget();
+		NumOver += bOver ? 1 : 0;
+		Ar.Logf(TEXT("%-28s %8d %12.1f %10d %12.1f%s"),
+			*(Row.bProcessTotal ? Row.Name + TEXT(" (process)") : Row.Name),
+			Row.Count,
+			Row.Bytes / 1024.0,
+			Row.Budget ? Row.Budget->MaxCount : 0,
+			Row.Budget ? Row.Budget->MaxMB * 1024.0 : 0.0,
+			bOver ? TEXT("  OVER BUDGET") : TEXT(""));
+	}
+	return NumOver;
+}
+
+int32 DesertNinjasMemory::CheckBudgets(UWorld* World)
+{
+	TArray<FMemoryReportRow> Rows;
+	BuildReport(World, Rows);
+
+	int32 NumOver = 0;
+	for (const FMemoryReportRow& Row : Rows)
+	{
+		if (Row.IsOverBudget())
+		{
+			++NumOver;
+			UE_LOG(LogMemoryBudget, Warning, TEXT("%s over budget in %s: %d instances, %.1f KB (budget %d instances, %.1f KB)"),
+				*Row.Name, Row.bProcessTotal ? TEXT("the process") : World ? *World->GetMapName() : TEXT("all worlds"), Row.Count, Row.Bytes / 1024.0,
+				Row.Budget->MaxCount, Row.Budget->MaxMB * 1024.0);
+		}
+	}
+	return NumOver;
+}
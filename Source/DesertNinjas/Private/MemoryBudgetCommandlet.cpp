@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MemoryBudgetCommandlet.h"
+#include "MemoryBudget.h"
+
+#include "Engine/World.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMemoryBudgetCommandlet, Log, All);
+
+UMemoryBudgetCommandlet::UMemoryBudgetCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMemoryBudgetCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapParam;
+	if (!FParse::Value(*Params, TEXT("Map="), MapParam))
+	{
+		UE_LOG(LogMemoryBudgetCommandlet, Error, TEXT("Missing -Map=/Game/Maps/MapName"));
+		return 1;
+	}
+
+	TArray<FString> Maps;
+	MapParam.ParseIntoArray(Maps, TEXT("+"));
+
+	// LLM rows are process totals and only exist with -llm, say so rather than silently skipping their budgets
+	bool bLLMEnabled = false;
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	bLLMEnabled = FLowLevelMemTracker::IsEnabled();
+#endif
+	if (!bLLMEnabled)
+	{
+		UE_LOG(LogMemoryBudgetCommandlet, Warning, TEXT("LLM is off, LLM.* budgets are not checked. Run with -llm to include them."));
+	}
+
+	int32 NumOver = 0;
+	for (const FString& Map : Maps)
+	{
+		UPackage* Package = LoadPackage(nullptr, *Map, LOAD_None);
+		UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+		if (!World)
+		{
+			UE_LOG(LogMemoryBudgetCommandlet, Error, TEXT("Could not load map %s"), *Map);
+			return 1;
+		}
+
+		// A loaded map has no registered components yet, initialize it like the editor would
+		World->AddToRoot();
+		if (!World->bIsWorldInitialized)
+		{
+			UWorld::InitializationValues IVS;
+			IVS.RequiresHitProxies(false)
+				.ShouldSimulatePhysics(false)
+				.EnableTraceCollision(false)
+				.CreateNavigation(false)
+				.CreateAISystem(false)
+				.AllowAudioPlayback(false);
+			World->InitWorld(IVS);
+		}
+		World->UpdateWorldComponents(true, false);
+
+		UE_LOG(LogMemoryBudgetCommandlet, Display, TEXT("Memory report for %s"), *Map);
+		TArray<FMemoryReportRow> Rows;
+		DesertNinjasMemory::BuildReport(World, Rows);
+		const int32 MapOver = DesertNinjasMemory::PrintReport(Rows, *GLog);
+		if (MapOver > 0)
+		{
+			UE_LOG(LogMemoryBudgetCommandlet, Error, TEXT("%s exceeds %d memory budget(s)"), *Map, MapOver);
+		}
+		NumOver += MapOver;
+
+		World->RemoveFromRoot();
+		World->CleanupWorld();
+		CollectGarbage(RF_NoFlags);
+	}
+
+	return NumOver > 0 ? 1 : 0;
+#else
+	return 0;
+#endif
+}
@@ -7,6 +7,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "Engine/World.h"
 #include "Sound/SoundCue.h"
+#include "MemoryBudget.h"
 
 APickup::APickup()
 {
@@ -21,29 +22,28 @@ void APickup::OnOverlapBegin(
 	Super::OnOverlapBegin(OverlappedComponent, OtherActor, OtherComp, 
 		OtherBodyIndex, bFromSweep, SweepResult);
 
-	if (OtherActor)
+	// The server decides, clients get the effects through the collected multicast.
+	// Pickups with a definition are handled by the item system.
+	if (!Definition && OtherActor && HasAuthority())
 	{
 		ADesertNinjasCharacter* Main = Cast<ADesertNinjasCharacter>(OtherActor);
 		if (Main)
 		{
-			OnPickupBP(Main);
-			Main->PickupLocations.Add(GetActorLocation());
-
-			if (OverlapParticles)
-			{
-				UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), OverlapParticles,
-					GetActorLocation(), FRotator(0.f), true);
-			}
-			if (OverlapSound)
 			{
-				UGameplayStatics::PlaySound2D(this, OverlapSound);
+				DN_LLM_SCOPE(Characters);
+				Main->PickupLocations.Add(GetActorLocation());
 			}
 
-			Destroy();
+			Collect(Main);
 		}
 	}
 }
 
+void APickup::PlayCollectedEvents(ADesertNinjasCharacter* Collector)
+{
+	OnPickupBP(Collector);
+}
+
 void APickup::OnOverlapEnd(UPrimitiveComponent* OverlappedComponent,
 	AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
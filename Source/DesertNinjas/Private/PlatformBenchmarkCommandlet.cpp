@@ -0,0 +1,129 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PlatformBenchmarkCommandlet.h"
+#include "FloatingPlatform.h"
+#include "HeadlessWorld.h"
+
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/PlatformTime.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogPlatformBenchmark, Log, All);
+
+namespace
+{
+	const TCHAR* PlatformMeshPath = TEXT("/Engine/BasicShapes/Cube.Cube");
+	const float FrameTime = 1.f / 60.f;
+
+	struct FPlatformBenchmarkResult
+	{
+		double AvgMs = 0.0;
+		double MaxMs = 0.0;
+		int32 RidersOnPlatform = 0;
+	};
+
+	/** bOldBehaviour puts back what platforms did before they moved kinematically: overlap events,
+		navigation relevance and the old VInterpTo movement with its timer and no base velocity */
+	FPlatformBenchmarkResult RunPass(UStaticMesh* PlatformMesh, int32 NumPlatforms, int32 NumFrames, bool bOldBehaviour)
+	{
+		FScopedHeadlessWorld Headless(TEXT("PlatformBenchmark"));
+		UWorld* World = Headless.World;
+
+		TArray<AFloatingPlatform*> Platforms;
+		TArray<ACharacter*> Riders;
+		for (int32 Index = 0; Index < NumPlatforms; ++Index)
+		{
+			// Spread out so riders only ever touch their own platform
+			const FVector Location(Index * 2000.f, 0.f, 0.f);
+
+			AFloatingPlatform* Platform = World->SpawnActor<AFloatingPlatform>(Location, FRotator::ZeroRotator);
+			Platform->Mesh->SetStaticMesh(PlatformMesh);
+			Platform->Mesh->SetGenerateOverlapEvents(bOldBehaviour);
+			Platform->Mesh->SetCanEverAffectNavigation(bOldBehaviour);
+			Platform->SetActorScale3D(FVector(4.f, 4.f, 0.25f));
+			Platform->EndPoint = FVector(600.f, 0.f, (Index % 2) * 300.f);
+			Platform->bLegacyMovement = bOldBehaviour;
+			Platforms.Add(Platform);
+
+			ACharacter* Rider = World->SpawnActor<ACharacter>(Location + FVector(0.f, 0.f, 150.f), FRotator::ZeroRotator);
+			Rider->GetCharacterMovement()->bRunPhysicsWithNoController = true;
+			Riders.Add(Rider);
+		}
+
+		World->InitializeActorsForPlay(FURL());
+		World->GetWorldSettings()->NotifyBeginPlay();
+
+		auto TickWorld = [World]()
+		{
+			World->Tick(LEVELTICK_All, FrameTime);
+		};
+
+		// Let the riders land before measuring
+		for (int32 Frame = 0; Frame < 60; ++Frame)
+		{
+			TickWorld();
+		}
+
+		FPlatformBenchmarkResult Result;
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double Start = FPlatformTime::Seconds();
+			TickWorld();
+			const double Ms = (FPlatformTime::Seconds() - Start) * 1000.0;
+
+			Result.AvgMs += Ms / NumFrames;
+			Result.MaxMs = FMath::Max(Result.MaxMs, Ms);
+		}
+
+		for (int32 Index = 0; Index < Riders.Num(); ++Index)
+		{
+			if (Riders[Index]->GetMovementBase() == Platforms[Index]->Mesh)
+			{
+				++Result.RidersOnPlatform;
+			}
+		}
+		return Result;
+	}
+}
+
+UPlatformBenchmarkCommandlet::UPlatformBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UPlatformBenchmarkCommandlet::Main(const FString& Params)
+{
+	int32 NumPlatforms = 300;
+	int32 NumFrames = 600;
+	FParse::Value(*Params, TEXT("Platforms="), NumPlatforms);
+	FParse::Value(*Params, TEXT("Frames="), NumFrames);
+	if (NumPlatforms <= 0 || NumFrames <= 0)
+	{
+		UE_LOG(LogPlatformBenchmark, Error, TEXT("-Platforms and -Frames must be positive"));
+		return 1;
+	}
+
+	UStaticMesh* PlatformMesh = LoadObject<UStaticMesh>(nullptr, PlatformMeshPath);
+	if (!PlatformMesh)
+	{
+		UE_LOG(LogPlatformBenchmark, Error, TEXT("Could not load %s"), PlatformMeshPath);
+		return 1;
+	}
+
+	const FPlatformBenchmarkResult Old = RunPass(PlatformMesh, NumPlatforms, NumFrames, true);
+	const FPlatformBenchmarkResult Kinematic = RunPass(PlatformMesh, NumPlatforms, NumFrames, false);
+
+	UE_LOG(LogPlatformBenchmark, Display, TEXT("PlatformBenchmark platforms=%d riders=%d frames=%d"), NumPlatforms, NumPlatforms, NumFrames);
+	UE_LOG(LogPlatformBenchmark, Display, TEXT("  old             avg_ms=%.3f max_ms=%.3f riders_on_platform=%d"), Old.AvgMs, Old.MaxMs, Old.RidersOnPlatform);
+	UE_LOG(LogPlatformBenchmark, Display, TEXT("  kinematic       avg_ms=%.3f max_ms=%.3f riders_on_platform=%d"), Kinematic.AvgMs, Kinematic.MaxMs, Kinematic.RidersOnPlatform);
+
+	return 0;
+}
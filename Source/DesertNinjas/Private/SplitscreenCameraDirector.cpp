@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SplitscreenCameraDirector.h"
+
+#include "DesertNinjas.h"
+#include "DesertNinjasCharacter.h"
+#include "Camera/CameraActor.h"
+#include "Camera/CameraComponent.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Camera Director"), STAT_CameraDirector, STATGROUP_DesertNinjas);
+
+void USplitscreenCameraDirector::Deinitialize()
+{
+	if (SharedCamera)
+	{
+		SharedCamera->Destroy();
+		SharedCamera = nullptr;
+	}
+	Cullables.Reset();
+
+	Super::Deinitialize();
+}
+
+bool USplitscreenCameraDirector::IsTickable() const
+{
+	const UWorld* World = GetWorld();
+	return World && World->IsGameWorld() && !IsTemplate();
+}
+
+TStatId USplitscreenCameraDirector::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USplitscreenCameraDirector, STATGROUP_Tickables);
+}
+
+void USplitscreenCameraDirector::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CameraDirector);
+
+	UWorld* World = GetWorld();
+
+	TArray<APlayerController*> Players;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->IsLocalController() && PlayerController->GetPawn())
+		{
+			Players.Add(PlayerController);
+		}
+	}
+
+	VisibleRanges.Reset();
+	UpdateSharedView(Players, DeltaTime);
+
+	if (!bMerged)
+	{
+		for (APlayerController* PlayerController : Players)
+		{
+			if (PlayerController->PlayerCameraManager)
+			{
+				const FMinimalViewInfo& View = PlayerController->PlayerCameraManager->GetCameraCachePOV();
+				AddVisibleRange(View.Location.X - View.OrthoWidth * 0.5f, View.Location.X + View.OrthoWidth * 0.5f);
+			}
+		}
+	}
+
+	UpdateCulling();
+}
+
+void USplitscreenCameraDirector::UpdateSharedView(const TArray<APlayerController*>& Players, float DeltaTime)
+{
+	// A single player keeps the camera on its own character
+	if (Players.Num() < 2)
+	{
+		SetMerged(Players, false);
+		return;
+	}
+
+	float MinX = TNumericLimits<float>::Max();
+	float MaxX = TNumericLimits<float>::Lowest();
+	FVector Center = FVector::ZeroVector;
+	for (APlayerController* PlayerController : Players)
+	{
+		const FVector Location = PlayerController->GetPawn()->GetActorLocation();
+		MinX = FMath::Min(MinX, Location.X);
+		MaxX = FMath::Max(MaxX, Location.X);
+		Center += Location;
+	}
+	Center /= Players.Num();
+	Center.X = (MinX + MaxX) * 0.5f;
+
+	const float RequiredWidth = (MaxX - MinX) + ScreenEdgeMargin * 2.f;
+	if (bMerged && RequiredWidth > MaxMergedOrthoWidth)
+	{
+		SetMerged(Players, false);
+	}
+	else if (!bMerged && RequiredWidth < MaxMergedOrthoWidth * MergeHysteresis)
+	{
+		SetMerged(Players, true);
+	}
+
+	if (!bMerged || !SharedCamera) return;
+
+	const float TargetWidth = FMath::Clamp(RequiredWidth, MinMergedOrthoWidth, MaxMergedOrthoWidth);
+	SharedOrthoWidth = FMath::FInterpTo(SharedOrthoWidth, TargetWidth, DeltaTime, OrthoWidthInterpSpeed);
+
+	// Place the shared camera the way the character's boom places its own camera
+	FVector CameraOffset(0.f, 500.f, 75.f);
+	FRotator CameraRotation(0.f, -90.f, 0.f);
+	const ADesertNinjasCharacter* Character = Cast<ADesertNinjasCharacter>(Players[0]->GetPawn());
+	if (Character)
+	{
+		const UCameraComponent* Camera = Character->GetSideViewCameraComponent();
+		CameraOffset = Camera->GetComponentLocation() - Character->GetActorLocation();
+		CameraRotation = Camera->GetComponentRotation();
+	}
+
+	SharedCamera->SetActorLocationAndRotation(Center + CameraOffset, CameraRotation);
+	SharedCamera->GetCameraComponent()->SetOrthoWidth(SharedOrthoWidth);
+
+	AddVisibleRange(Center.X - SharedOrthoWidth * 0.5f, Center.X + SharedOrthoWidth * 0.5f);
+}
+
+void USplitscreenCameraDirector::SetMerged(const TArray<APlayerController*>& Players, bool bNewMerged)
+{
+	if (bMerged == bNewMerged) return;
+	bMerged = bNewMerged;
+
+	UWorld* World = GetWorld();
+	if (bMerged && !SharedCamera)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		SharedCamera = World->SpawnActor<ACameraActor>(SpawnParams);
+		SharedCamera->GetCameraComponent()->ProjectionMode = ECameraProjectionMode::Orthographic;
+	}
+	if (bMerged)
+	{
+		// Start from the width the players already see so merging does not pop
+		SharedOrthoWidth = MinMergedOrthoWidth;
+	}
+
+	// Only the first player's view is drawn while splitscreen is off
+	if (UGameViewportClient* Viewport = World->GetGameViewport())
+	{
+		Viewport->SetForceDisableSplitscreen(bMerged);
+	}
+
+	for (APlayerController* PlayerController : Players)
+	{
+		PlayerController->SetViewTarget(bMerged ? (AActor*)SharedCamera : (AActor*)PlayerController->GetPawn());
+	}
+}
+
+void USplitscreenCameraDirector::AddVisibleRange(float Min, float Max)
+{
+	// Keep the ranges sorted and merged so lookups stay a short scan
+	int32 Index = 0;
+	while (Index < VisibleRanges.Num() && VisibleRanges[Index].Max < Min) ++Index;
+
+	FVisibleRange Merged{ Min, Max };
+	while (Index < VisibleRanges.Num() && VisibleRanges[Index].Min <= Merged.Max)
+	{
+		Merged.Min = FMath::Min(Merged.Min, VisibleRanges[Index].Min);
+		Merged.Max = FMath::Max(Merged.Max, VisibleRanges[Index].Max);
+		VisibleRanges.RemoveAt(Index, 1, false);
+	}
+	VisibleRanges.Insert(Merged, Index);
+}
+
+bool USplitscreenCameraDirector::IsRangeVisible(float MinX, float MaxX) const
+{
+	// Servers and worlds without local players cull nothing
+	if (VisibleRanges.Num() == 0) return true;
+
+	for (const FVisibleRange& Range : VisibleRanges)
+	{
+		if (Range.Min <= MaxX && MinX <= Range.Max)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void USplitscreenCameraDirector::RegisterCullable(AActor* Actor)
+{
+	if (Actor)
+	{
+		Cullables.Add(Actor);
+	}
+}
+
+void USplitscreenCameraDirector::UnregisterCullable(AActor* Actor)
+{
+	Cullables.Remove(Actor);
+}
+
+void USplitscreenCameraDirector::UpdateCulling()
+{
+	for (AActor* Actor : Cullables)
+	{
+		if (!Actor || Actor->IsPendingKill()) continue;
+
+		const float X = Actor->GetActorLocation().X;
+		const bool bVisible = IsRangeVisible(X - CullMargin, X + CullMargin);
+		if (Actor->IsActorTickEnabled() != bVisible)
+		{
+			Actor->SetActorTickEnabled(bVisible);
+		}
+	}
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "BakeSpriteAtlasCommandlet.generated.h"
+
+/**
+ * Packs the frames of every sprite under a content path into a few shared atlas pages,
+ * re-points the sprites at the pages and writes a USpriteAtlasTable next to them.
+ * Sprites that share a texture can then be batched by Paper2D.
+ *
+ * Usage:
+ *   UE4Editor-Cmd DesertNinjas.uproject -run=BakeSpriteAtlas
+ *     [-Group=Character:/Game/Character/Animation] [-Group=...] [-AtlasSize=2048] [-Padding=2] [-DryRun]
+ *
+ * Without -Group the character animations and the level item sprites are baked.
+ * Logs texture memory before and after for each group.
+ */
+UCLASS()
+class UBakeSpriteAtlasCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UBakeSpriteAtlasCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
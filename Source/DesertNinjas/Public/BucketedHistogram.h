@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Histogram over fixed buckets, cheap enough to feed every frame.
+ * Percentiles are reported as the upper bound of the bucket they fall in.
+ */
+struct DESERTNINJAS_API FBucketedHistogram
+{
+	/** Millisecond buckets from 1 ms to 1 s, with finer steps around common frame times */
+	FBucketedHistogram();
+
+	/** Ascending upper bounds; values above the last one go into an open-ended bucket */
+	explicit FBucketedHistogram(TArray<float> InUpperBounds);
+
+	void Add(float Value);
+
+	/** Takes back a value previously added, for rolling windows. Min and max are not restored, see SetRange. */
+	void Remove(float Value);
+
+	/** Replaces min and max, for rolling windows whose owner still holds the values after a Remove */
+	void SetRange(float InMin, float InMax);
+
+	void Reset();
+
+	int32 Num() const { return Count; }
+	float GetMean() const { return Count > 0 ? (float)(Sum / Count) : 0.f; }
+	float GetMin() const { return Count > 0 ? Min : 0.f; }
+	float GetMax() const { return Count > 0 ? Max : 0.f; }
+
+	/** Upper bound of the bucket holding the given fraction (0-1) of the values, or the max for the open bucket */
+	float GetPercentile(float Fraction) const;
+
+	const TArray<float>& GetUpperBounds() const { return UpperBounds; }
+
+	// One more than the bounds, the last one is the open-ended bucket
+	const TArray<uint32>& GetCounts() const { return Counts; }
+
+	/** "n=.. mean=.. p50=.. p95=.. p99=.. max=.." */
+	FString ToString() const;
+
+	/** Bucket counts as comma separated values, matching GetCsvHeader */
+	FString ToCsvBuckets() const;
+	FString GetCsvHeader() const;
+
+private:
+	int32 FindBucket(float Value) const;
+
+	TArray<float> UpperBounds;
+	TArray<uint32> Counts;
+	int32 Count;
+	double Sum;
+	float Min;
+	float Max;
+};
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollectibleBitset.generated.h"
+
+/**
+ * Dense bitset of collected items, indexed by AItem::ItemIndex.
+ * One bit per placed item keeps replication and checkpoint saves tiny.
+ */
+USTRUCT(BlueprintType)
+struct FCollectibleBitset
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<uint32> Words;
+
+	bool Contains(int32 Index) const
+	{
+		const int32 Word = Index >> 5;
+		return Index >= 0 && Word < Words.Num() && (Words[Word] & (1u << (Index & 31))) != 0;
+	}
+
+	void Add(int32 Index)
+	{
+		check(Index >= 0);
+		const int32 Word = Index >> 5;
+		if (Word >= Words.Num())
+		{
+			Words.SetNumZeroed(Word + 1);
+		}
+		Words[Word] |= 1u << (Index & 31);
+	}
+
+	// Number of collected items
+	int32 Num() const
+	{
+		int32 Count = 0;
+		for (uint32 Word : Words)
+		{
+			Count += FMath::CountBits(Word);
+		}
+		return Count;
+	}
+
+	void Reset()
+	{
+		Words.Reset();
+	}
+};
+
+/** Collected items of one level, keyed by the level's package name without PIE prefix */
+USTRUCT(BlueprintType)
+struct FLevelCollectibleState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FName LevelName;
+
+	UPROPERTY()
+	FCollectibleBitset Collected;
+};
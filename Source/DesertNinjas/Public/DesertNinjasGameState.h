@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "CollectibleBitset.h"
+#include "DesertNinjasGameState.generated.h"
+
+class AItem;
+
+/**
+ * Holds the replicated, per-level record of which placed items have been collected.
+ * Late joiners receive the bitsets and hide the matching items on arrival, and restoring a
+ * checkpoint brings back items collected since.
+ */
+UCLASS()
+class DESERTNINJAS_API ADesertNinjasGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+public:
+	ADesertNinjasGameState();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Returns true if this placed item was already collected */
+	bool IsItemCollected(const AItem* Item) const;
+
+	/** Records a collected item (authority only) */
+	void MarkItemCollected(AItem* Item);
+
+	/** Items register on BeginPlay, collected or not, so replicated state can be applied to them */
+	void RegisterItem(AItem* Item);
+	void UnregisterItem(AItem* Item);
+
+	/** Checkpoint support */
+	UFUNCTION(BlueprintCallable, Category = "Collectibles")
+	const TArray<FLevelCollectibleState>& GetCollectedItems() const { return CollectedItems; }
+
+	UFUNCTION(BlueprintCallable, Category = "Collectibles")
+	void RestoreCollectedItems(const TArray<FLevelCollectibleState>& SavedState);
+
+protected:
+	UPROPERTY(ReplicatedUsing = OnRep_CollectedItems)
+	TArray<FLevelCollectibleState> CollectedItems;
+
+	// Bumped by every checkpoint restore, so clients know to bring back items as well
+	UPROPERTY(ReplicatedUsing = OnRep_CollectedItems)
+	int32 RestoreCount;
+
+	int32 AppliedRestoreCount;
+
+	UFUNCTION()
+	void OnRep_CollectedItems();
+
+	/** Hides every registered item whose bit is set. A restore also reactivates collected items whose bit is clear;
+		otherwise a clear bit may just not have caught up with the collection multicast yet. */
+	void ApplyCollectedItems(bool bRestore);
+
+	const FCollectibleBitset* FindLevelState(FName LevelName) const;
+
+	/** Registered items per level, indexed by ItemIndex */
+	TMap<FName, TArray<TWeakObjectPtr<AItem>>> RegisteredItems;
+};
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "DesertNinjasPlayerController.generated.h"
+
+UENUM()
+enum class EBotBehavior : uint8
+{
+	BB_None UMETA(DisplayName = "None"),
+	BB_RandomWalk UMETA(DisplayName = "Random Walk"),
+	BB_Scripted UMETA(DisplayName = "Scripted")
+};
+
+/**
+ * Player controller that can drive its own pawn for load testing.
+ * Started with -Bot the controller injects the same keys a player would press
+ * (looked up from the MoveRight/Jump/Attack/Throw mappings), so bots exercise
+ * the normal input, prediction and replication paths.
+ *
+ *   -Bot                      random walk
+ *   -Bot -BotScript=R2,J,A,L1.5,T,W1
+ *                             repeat: right 2s, jump, attack, left 1.5s, throw, wait 1s
+ *   -BotSeed=N                seed for reproducible runs
+ */
+UCLASS()
+class DESERTNINJAS_API ADesertNinjasPlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+public:
+	ADesertNinjasPlayerController();
+
+	virtual void PlayerTick(float DeltaTime) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Bot")
+	EBotBehavior BotBehavior;
+
+	/** Seconds between random walk decisions */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bot")
+	FVector2D DecisionInterval;
+
+	/** Chance per decision to jump, attack or throw */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bot")
+	float JumpChance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bot")
+	float AttackChance;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bot")
+	float ThrowChance;
+
+private:
+	struct FBotStep
+	{
+		TCHAR Action;
+		float Duration;
+	};
+
+	void ParseScript(const FString& Script);
+	void TickRandomWalk(float DeltaTime);
+	void TickScript(float DeltaTime);
+
+	// Press the first key mapped to the action, it is released on the next tick
+	void TapAction(FName ActionName);
+
+	TArray<FKey> PendingReleases;
+
+	TArray<FBotStep> Script;
+	int32 ScriptStep;
+
+	FRandomStream Random;
+	float MoveDirection;
+	float TimeToNextDecision;
+};
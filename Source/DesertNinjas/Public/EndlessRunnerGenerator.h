@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Async/Future.h"
+#include "EndlessRunnerGenerator.generated.h"
+
+class UEndlessSegment;
+
+/** A placed (or pooled) copy of a segment */
+USTRUCT()
+struct FEndlessSegmentInstance
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> Actors;
+
+	int32 SegmentIndex = INDEX_NONE;
+	float StartX = 0.f;
+	float EndX = 0.f;
+};
+
+USTRUCT()
+struct FEndlessSegmentPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FEndlessSegmentInstance> Free;
+};
+
+/** What the layout task needs to know about a segment, copied so it never touches UObjects */
+struct FEndlessSegmentShape
+{
+	float Length;
+	float Weight;
+	TArray<float> SpawnChances;
+};
+
+/** A segment chosen by the layout task, with the elements that are present this time */
+struct FEndlessSegmentLayout
+{
+	int32 SegmentIndex;
+	float StartX;
+	TBitArray<> EnabledElements;
+};
+
+struct FEndlessLayoutBatch
+{
+	TArray<FEndlessSegmentLayout> Segments;
+	FRandomStream Stream;
+	float EndX = 0.f;
+	int32 LastSegmentIndex = INDEX_NONE;
+};
+
+/**
+ * Builds an endless level from pre-authored segments ahead of the players along X and
+ * recycles the ones behind them into per-segment pools. Segment choice is computed in
+ * batches on a background task from a seeded stream, so a given seed always yields the
+ * same level. Runs on the authority and spawns its pooled actors without replication, so the
+ * mode is meant for standalone and splitscreen play.
+ */
+UCLASS()
+class DESERTNINJAS_API AEndlessRunnerGenerator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AEndlessRunnerGenerator();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Endless")
+	TArray<UEndlessSegment*> Segments;
+
+	/** 0 picks a new seed each run; -EndlessSeed=N on the command line overrides it */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Endless")
+	int32 Seed;
+
+	// Keep segments placed this far ahead of the leading player
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Endless")
+	float GenerateAheadDistance;
+
+	// Recycle segments that end this far behind the last player
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Endless")
+	float RecycleBehindDistance;
+
+	// Segments chosen per layout task
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Endless")
+	int32 LayoutBatchSize;
+
+	// Copies of each segment spawned up front so the first placements don't spawn actors
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Endless")
+	int32 PrewarmPerSegment;
+
+	int32 GetSeed() const { return LayoutStream.GetInitialSeed(); }
+
+protected:
+	virtual void BeginPlay() override;
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	static FEndlessLayoutBatch ComputeLayout(const TArray<FEndlessSegmentShape>& SegmentShapes, FRandomStream Stream, float StartX, int32 LastSegmentIndex, int32 Count);
+
+	void StartLayout();
+	void ApplyLayout(const FEndlessLayoutBatch& Batch);
+
+	FEndlessSegmentInstance SpawnSegment(int32 SegmentIndex);
+	FEndlessSegmentInstance AcquireSegment(int32 SegmentIndex);
+	void PlaceSegment(FEndlessSegmentInstance& Instance, const FEndlessSegmentLayout& Layout);
+	void ReleaseSegment(FEndlessSegmentInstance& Instance);
+
+	static void ActivateElement(AActor* Actor);
+	static void DeactivateElement(AActor* Actor);
+
+	bool GetPlayerRange(float& OutMinX, float& OutMaxX) const;
+
+	UPROPERTY()
+	TArray<FEndlessSegmentInstance> ActiveSegments;
+
+	// Parallel to Segments
+	UPROPERTY()
+	TArray<FEndlessSegmentPool> Pools;
+
+	TSharedPtr<const TArray<FEndlessSegmentShape>, ESPMode::ThreadSafe> Shapes;
+
+	// Chosen but not yet placed
+	TArray<FEndlessSegmentLayout> Planned;
+
+	TFuture<FEndlessLayoutBatch> PendingLayout;
+
+	// State the next layout task continues from
+	FRandomStream LayoutStream;
+	float LayoutEndX;
+	int32 LastLayoutSegment;
+};
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "EndlessSegment.generated.h"
+
+/** One actor of a segment, e.g. a BaseFloor, FloatingIsland, OlympicRamp, platform or item */
+USTRUCT(BlueprintType)
+struct FEndlessSegmentElement
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Segment")
+	TSubclassOf<AActor> ActorClass;
+
+	// Relative to the segment's start
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Segment")
+	FTransform RelativeTransform;
+
+	// Chance the element is present each time the segment is placed
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Segment", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float SpawnChance = 1.f;
+};
+
+/**
+ * Pre-authored piece of level for the endless mode. Segments are placed end to end along X,
+ * each one starting where the previous one ends.
+ */
+UCLASS(BlueprintType)
+class DESERTNINJAS_API UEndlessSegment : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Distance along X from this segment's start to the next one's
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Segment")
+	float Length = 2048.f;
+
+	// Relative chance of picking this segment
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Segment", meta = (ClampMin = "0.0"))
+	float Weight = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Segment")
+	TArray<FEndlessSegmentElement> Elements;
+};
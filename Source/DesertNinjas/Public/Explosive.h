@@ -30,5 +30,8 @@ public:
 
 	UFUNCTION(BlueprintImplementableEvent, Category = "Damage")
 	void OnExplosionBP(class ADesertNinjasCharacter* Target);
+
+protected:
+	virtual void PlayCollectedEvents(class ADesertNinjasCharacter* Collector) override;
 	
 };
@@ -6,6 +6,29 @@
 #include "GameFramework/Actor.h"
 #include "FloatingPlatform.generated.h"
 
+/** Everything needed to compute where a platform is at any time */
+USTRUCT()
+struct FFloatingPlatformPath
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FVector StartPoint = FVector::ZeroVector;
+
+	UPROPERTY()
+	FVector EndPoint = FVector::ZeroVector;
+
+	UPROPERTY()
+	float InterpSpeed = 0.f;
+
+	UPROPERTY()
+	float InterpTime = 0.f;
+
+	// Server world time the first pause started at
+	UPROPERTY()
+	float StartTime = 0.f;
+};
+
 UCLASS()
 class DESERTNINJAS_API AFloatingPlatform : public AActor
 {
@@ -31,23 +54,59 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Platform")
 	float InterpTime;
 
-	FTimerHandle InterpTimer;
-
+	// True while the platform is moving between its end points
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Platform")
 	bool bInterping;
 
 	float Distance;
 
+	/** Viewers further than this along X don't receive the platform */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Platform | Replication")
+	float NetRelevancyHalfWidth;
+
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	/** Moves like platforms did before they followed a timed path: VInterpTo every tick, a world timer
+		toggling the pauses and no base velocity. Only PlatformBenchmark sets it, before BeginPlay, to
+		measure the old movement against the new one. */
+	bool bLegacyMovement;
+
+	/** Moves the whole path so it starts at NewStartPoint and restarts it from the first pause.
+		The path only replicates initially, so this is for platforms that are not yet relevant to clients. */
+	void RestartPath(const FVector& NewStartPoint);
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	/** Sent once when the platform starts, afterwards it goes dormant and clients simulate it */
+	UPROPERTY(ReplicatedUsing = OnRep_Path)
+	FFloatingPlatformPath Path;
+
+	UFUNCTION()
+	void OnRep_Path();
+
+	bool bPathReceived;
+
+	// Seconds to travel one leg, the continuous form of VInterpTo stopping 1 unit short of the end
+	float TravelTime;
+
+	void UpdatePathTiming();
+
+	/** Location and velocity on the path at the given server time */
+	FVector EvaluatePath(float Time, FVector& OutVelocity);
+
+	float GetPathTime() const;
+
+	FTimerHandle LegacyInterpTimer;
+
+	void TickLegacyMovement(float DeltaTime);
+	void ToggleLegacyInterping();
+
 public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
-	void ToggleInterping();
-
-	void SwapVectors(FVector& VecOne, FVector& VecTwo);
-
 };
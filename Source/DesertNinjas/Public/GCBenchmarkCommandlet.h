@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GCBenchmarkCommandlet.generated.h"
+
+/**
+ * Spawns a large number of items in a headless world and measures full garbage collection
+ * passes with the items unclustered and then grouped into a GC cluster.
+ *
+ * Usage:
+ *   UE4Editor-Cmd DesertNinjas.uproject -run=GCBenchmark [-Count=10000] [-Passes=5] [-ItemClass=/Game/Path/Pickup_BP.Pickup_BP_C] [-ListClusters]
+ */
+UCLASS()
+class UGCBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGCBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
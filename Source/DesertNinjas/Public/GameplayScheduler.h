@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "GameplayTimingWheel.h"
+#include "GameplayScheduler.generated.h"
+
+/**
+ * Per-world scheduler for short-lived gameplay timers (animation recovery, respawns, platform pauses).
+ * Timers are kept in a timing wheel instead of the global timer heap and are all dispatched
+ * together once per frame, after actors have ticked.
+ * Callbacks bound to a UObject are skipped if the object has been destroyed.
+ */
+UCLASS(config=Game)
+class DESERTNINJAS_API UGameplayScheduler : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	UGameplayScheduler();
+
+	static UGameplayScheduler* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End of FTickableGameObject interface
+
+	/** Cancels whatever InOutHandle refers to and schedules Method on Object after Delay seconds */
+	template <class UserClass>
+	void SetTimer(FGameplayTimerHandle& InOutHandle, UserClass* Object, typename TMemFunPtrType<false, UserClass, void()>::Type Method, float Delay, bool bLoop = false)
+	{
+		SetTimer(InOutHandle, FSimpleDelegate::CreateUObject(Object, Method), Delay, bLoop);
+	}
+
+	void SetTimer(FGameplayTimerHandle& InOutHandle, FSimpleDelegate Callback, float Delay, bool bLoop = false);
+
+	void ClearTimer(FGameplayTimerHandle& Handle);
+
+	bool IsTimerActive(const FGameplayTimerHandle& Handle) const;
+
+	/** Seconds until the timer fires, or -1 if it is not active */
+	float GetTimerRemaining(const FGameplayTimerHandle& Handle) const;
+
+protected:
+	/** Timer granularity in seconds; delays are rounded up to a whole number of ticks */
+	UPROPERTY(Config)
+	float TickResolution;
+
+	FGameplayTimingWheel Wheel;
+};
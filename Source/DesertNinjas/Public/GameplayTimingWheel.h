@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Cancellable handle to a timer in a FGameplayTimingWheel. Not interchangeable with FTimerHandle. */
+struct FGameplayTimerHandle
+{
+	bool IsValid() const { return Serial != 0; }
+	void Invalidate() { Index = INDEX_NONE; Serial = 0; }
+
+	bool operator==(const FGameplayTimerHandle& Other) const { return Index == Other.Index && Serial == Other.Serial; }
+	bool operator!=(const FGameplayTimerHandle& Other) const { return !(*this == Other); }
+
+private:
+	friend class FGameplayTimingWheel;
+
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+};
+
+/**
+ * Hierarchical timing wheel with a fixed tick resolution.
+ * Adding and cancelling a timer is O(1); advancing costs one slot per elapsed tick plus
+ * an occasional cascade of a higher level. Timers live in a pooled node array linked
+ * into per-slot lists, so short-lived timers cause no allocations once the pool is warm.
+ */
+class DESERTNINJAS_API FGameplayTimingWheel
+{
+public:
+	explicit FGameplayTimingWheel(double InTickInterval = 1.0 / 60.0);
+
+	/** Schedules Callback after Delay seconds, repeating every Delay seconds if bLoop */
+	FGameplayTimerHandle Add(double Delay, FSimpleDelegate Callback, bool bLoop = false);
+
+	/** Cancels the timer and invalidates the handle. Returns false if it was not pending. */
+	bool Remove(FGameplayTimerHandle& Handle);
+
+	bool IsPending(const FGameplayTimerHandle& Handle) const;
+
+	/** Seconds until the timer fires, or -1 if it is not pending */
+	double GetRemaining(const FGameplayTimerHandle& Handle) const;
+
+	/** Fires every timer that expired up to Time (seconds). Returns the number of timers fired. */
+	int32 Advance(double Time);
+
+	int32 Num() const { return NumPending; }
+
+	double GetTickInterval() const { return TickInterval; }
+
+private:
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 SlotsPerLevel = 1 << SlotBits;
+	static constexpr int32 NumLevels = 4;
+	static constexpr int32 NumSlots = SlotsPerLevel * NumLevels;
+	// Extra list holding the timers of the slot being fired, so callbacks can cancel them
+	static constexpr int32 FiringList = NumSlots;
+	static constexpr int32 NoList = -1;
+
+	struct FNode
+	{
+		FSimpleDelegate Callback;
+		int64 ExpireTick = 0;
+		int64 IntervalTicks = 0;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+		int32 List = NoList;
+		uint32 Serial = 1;
+	};
+
+	int64 ToTicks(double Seconds) const;
+	bool IsValidHandle(const FGameplayTimerHandle& Handle) const;
+
+	void Link(int32 NodeIndex, int32 List);
+	void Unlink(int32 NodeIndex);
+	void Insert(int32 NodeIndex);
+	void Release(int32 NodeIndex);
+	void Cascade(int32 Level);
+	int32 FireSlot(int32 Slot);
+
+	TArray<FNode> Nodes;
+	int32 FreeHead = INDEX_NONE;
+	int32 Heads[NumSlots + 1];
+
+	double TickInterval;
+	int64 CurrentTick = 0;
+	int32 NumPending = 0;
+};
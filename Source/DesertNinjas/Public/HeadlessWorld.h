@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/** Game world without viewport or networking for commandlet benchmarks, destroyed with the scope */
+struct DESERTNINJAS_API FScopedHeadlessWorld
+{
+	explicit FScopedHeadlessWorld(FName Name);
+	~FScopedHeadlessWorld();
+
+	UWorld* World;
+};
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BucketedHistogram.h"
+#include "HitchMonitor.generated.h"
+
+/** One frame as remembered by the hitch monitor */
+struct FHitchFrame
+{
+	uint64 FrameNumber = 0;
+	float FrameMs = 0.f;
+	float GameThreadMs = 0.f;
+	float RenderThreadMs = 0.f;
+	int32 ActiveItems = 0;
+	uint16 ActorSpawns = 0;
+	uint16 ItemOverlaps = 0;
+	uint16 EmitterSpawns = 0;
+	bool bGarbageCollected = false;
+};
+
+/**
+ * Keeps rolling histograms of game and render thread time over the last frames of a game
+ * world. When a frame goes over DesertNinjas.HitchThresholdMs the recent frames and their
+ * gameplay counters are written to Saved/Hitches, which also works in headless sessions.
+ * Game thread time is measured from the world's tick start to the end of the frame, so it
+ * doesn't depend on viewport drawing; render thread time is only known where something renders.
+ */
+UCLASS(config=Game)
+class DESERTNINJAS_API UHitchMonitor : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UHitchMonitor* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Gameplay counters for the current frame
+	void CountItemOverlap() { ++Current.ItemOverlaps; }
+	void CountEmitterSpawn() { ++Current.EmitterSpawns; }
+	void AddActiveItems(int32 Delta) { ActiveItems += Delta; }
+
+	void Report(FOutputDevice& Ar) const;
+
+	/** Writes the last TraceFrames frames to Saved/Hitches and returns the file name */
+	FString DumpTrace(const TCHAR* Reason);
+
+protected:
+	/** Frames covered by the rolling histograms */
+	UPROPERTY(Config)
+	int32 WindowFrames = 600;
+
+	/** Frames written to a hitch trace, the hitch being the last one */
+	UPROPERTY(Config)
+	int32 TraceFrames = 120;
+
+	/** Traces closer together than this are skipped so a bad stretch doesn't flood the disk */
+	UPROPERTY(Config)
+	float MinSecondsBetweenTraces = 10.f;
+
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void OnEndFrame();
+	void OnActorSpawned(AActor* Actor);
+	void OnPreGarbageCollect();
+
+	const FHitchFrame& GetFrame(int32 FramesAgo) const;
+
+	// Min and max over the frames still in the window, the histograms can't take them back
+	void UpdateWindowRange();
+
+	TArray<FHitchFrame> Frames;
+	int32 NextFrame = 0;
+	int32 NumFrames = 0;
+
+	FBucketedHistogram GameThreadMs;
+	FBucketedHistogram RenderThreadMs;
+
+	FHitchFrame Current;
+	int32 ActiveItems = 0;
+	double LastTraceTime = -BIG_NUMBER;
+
+	// Cycles at this world's tick start, 0 until it ticks in the current frame
+	uint32 TickStartCycles = 0;
+
+	FDelegateHandle WorldTickStartHandle;
+	FDelegateHandle EndFrameHandle;
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle PreGarbageCollectHandle;
+};
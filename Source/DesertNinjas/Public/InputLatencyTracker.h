@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "BucketedHistogram.h"
+#include "InputLatencyTracker.generated.h"
+
+enum class EInputLatencyAction : uint8
+{
+	Jump,
+	Attack,
+	Throw,
+	Count
+};
+
+enum class EInputLatencyStage : uint8
+{
+	// Gameplay state changed (jump started, attack resolved)
+	Applied,
+	// The frame that set the action's flipbook is done on the game thread and goes to the renderer
+	Flipbook,
+	Count
+};
+
+/**
+ * Measures how long local player actions take from their input handler to the gameplay effect
+ * being applied and to the end of the frame that shows the new flipbook, per action.
+ * Results show up in "stat DesertNinjas", the DesertNinjas.InputLatency command and, with
+ * -InputLatencyCsv, in Saved/Profiling/InputLatency when the world shuts down.
+ */
+UCLASS()
+class DESERTNINJAS_API UInputLatencyTracker : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UInputLatencyTracker* Get(const UObject* WorldContextObject);
+
+	/** DesertNinjas.LowLatencyInput: apply actions in their input handler instead of the next animation update */
+	static bool IsLowLatencyEnabled();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	void MarkInput(const UObject* Source, EInputLatencyAction Action);
+
+	/** Flipbook marks are recorded when the current frame ends, the others right away */
+	void MarkStage(const UObject* Source, EInputLatencyAction Action, EInputLatencyStage Stage);
+
+	void Report(FOutputDevice& Ar) const;
+	void Reset();
+
+	bool WriteCsv(const FString& Filename) const;
+
+protected:
+	struct FPendingInput
+	{
+		double InputTime = 0.0;
+		uint64 InputFrame = 0;
+		bool bStageDone[(int32)EInputLatencyStage::Count] = {};
+		bool bActive = false;
+	};
+
+	struct FPendingInputs
+	{
+		FPendingInput Actions[(int32)EInputLatencyAction::Count];
+	};
+
+	struct FLatencyResults
+	{
+		FBucketedHistogram Milliseconds;
+		uint64 TotalFrames = 0;
+	};
+
+	void RecordStage(const FObjectKey& Source, EInputLatencyAction Action, EInputLatencyStage Stage);
+	void OnEndFrame();
+
+	TMap<FObjectKey, FPendingInputs> Pending;
+
+	// Flipbook marks waiting for the end of the frame
+	TArray<TPair<FObjectKey, EInputLatencyAction>> FlipbookMarks;
+	FDelegateHandle EndFrameHandle;
+
+	FLatencyResults Results[(int32)EInputLatencyAction::Count][(int32)EInputLatencyStage::Count];
+};
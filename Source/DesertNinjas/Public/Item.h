@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "GameplayTimingWheel.h"
 #include "Item.generated.h"
 
 UCLASS()
@@ -33,16 +34,64 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item | Sounds")
 	class USoundCue* OverlapSound;
 
+	/** Kind of item. When set, its mesh, effects and rotation replace the item's own and the
+		item system handles overlaps and rotation instead of subclass overlap code and Tick.
+		Its collision volume becomes a Collectible that only characters overlap. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item | Definition")
+	class UItemDefinition* Definition;
+
+	/** Called on the server and every client when the item is collected, after the server applied its effect */
+	UFUNCTION(BlueprintImplementableEvent, Category = "Item")
+	void OnItemCollectedBP(class ADesertNinjasCharacter* Target);
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item | ItemProperties")
 	bool bRotate;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item | ItemProperties")
 	float RotationRate;
 
+	/** Stable index of this item within its level, assigned whenever the level is saved or cooked.
+		Runtime-spawned items keep INDEX_NONE and are not tracked. */
+	UPROPERTY(VisibleInstanceOnly, NonPIEDuplicateTransient, Category = "Item | Collection")
+	int32 ItemIndex;
+
+	// Slot in the item system's rotating items, INDEX_NONE while not rotated by it
+	int32 RotatingItemIndex;
+
+	// Name of the level the item's index belongs to
+	FName GetCollectionLevelName() const;
+
+	// Records this item as collected in the game state so it is not spawned again
+	void MarkCollected();
+
+	/** Removes a collected item on every machine: records it, plays the overlap effects
+		through a single reliable multicast and puts the server copy back to sleep (authority only).
+		Collected items are deactivated rather than destroyed so their level's GC cluster stays intact.
+		Collector is passed on to the cosmetic events every machine plays. */
+	void Collect(class ADesertNinjasCharacter* Collector = nullptr);
+
+	// Hides the item and turns off its collision and tick
+	void HideAfterCollection();
+
+	// Undoes HideAfterCollection so a pooled item can be placed again
+	void Reactivate();
+
+	/** Viewers further than this along X don't receive the item */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item | Replication")
+	float NetRelevancyHalfWidth;
+
+	virtual bool IsNetRelevantFor(const AActor* RealViewer, const AActor* ViewTarget, const FVector& SrcLocation) const override;
+
+	virtual void PreSave(const class ITargetPlatform* TargetPlatform) override;
+
+	virtual void OnConstruction(const FTransform& Transform) override;
+
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -53,4 +102,20 @@ public:
 	UFUNCTION()
 		virtual void OnOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 
+protected:
+	UFUNCTION(NetMulticast, Reliable)
+	void MulticastCollected(class ADesertNinjasCharacter* Collector);
+
+	// Blueprint cosmetics of subclasses, played on the server and every client through the multicast
+	virtual void PlayCollectedEvents(class ADesertNinjasCharacter* Collector) {}
+
+	// Stops replicating the collected item once the multicast has gone out
+	void GoDormant();
+
+	FGameplayTimerHandle DormancyTimer;
+
+	// Keeps the hitch monitor's active item count in step
+	void SetCountedActive(bool bActive);
+	bool bCountedActive;
+
 };
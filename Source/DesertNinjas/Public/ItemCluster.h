@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "ItemCluster.generated.h"
+
+class AItem;
+
+/**
+ * Groups a fixed set of items (and their components) into one GC cluster so reachability
+ * analysis visits them as a single object. Level-placed items are clustered by their level in
+ * cooked builds; this is for items spawned in bulk, which the level cluster doesn't cover.
+ * The items must stay alive as long as the cluster: destroying one dissolves it.
+ */
+UCLASS()
+class DESERTNINJAS_API UItemCluster : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/** The returned cluster must be referenced by its owner to stay alive */
+	static UItemCluster* Create(UObject* Outer, const TArray<AItem*>& InItems);
+
+	virtual bool CanBeClusterRoot() const override { return true; }
+
+	const TArray<AItem*>& GetItems() const { return Items; }
+
+	/** Items that actually ended up in this cluster rather than only being referenced by it */
+	int32 GetNumClusteredItems() const;
+
+protected:
+	UPROPERTY()
+	TArray<AItem*> Items;
+};
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ItemDefinition.generated.h"
+
+class UParticleSystem;
+class USoundCue;
+class UStaticMesh;
+
+/** What touching the item does to the character; the item system processes each kind as one batch */
+UENUM(BlueprintType)
+enum class EItemEffect : uint8
+{
+	EIE_None UMETA(DisplayName = "None"),
+	EIE_Coins UMETA(DisplayName = "Coins"),
+	EIE_Health UMETA(DisplayName = "Health"),
+	EIE_Damage UMETA(DisplayName = "Damage"),
+	EIE_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+/**
+ * Describes a kind of item so new kinds are content rather than C++ subclasses.
+ * Assign it to any AItem; the item system then handles its overlaps and idle rotation.
+ */
+UCLASS(BlueprintType)
+class DESERTNINJAS_API UItemDefinition : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effect")
+	EItemEffect Effect = EItemEffect::EIE_None;
+
+	// Coins, health or damage given on touch
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effect")
+	float Amount = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Effect")
+	TSubclassOf<UDamageType> DamageTypeClass;
+
+	// Optional, replaces the item's own mesh and idle particles
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visuals")
+	UStaticMesh* Mesh = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visuals")
+	UParticleSystem* IdleParticles = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visuals")
+	UParticleSystem* OverlapParticles = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sounds")
+	USoundCue* OverlapSound = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visuals")
+	bool bRotate = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Visuals")
+	float RotationRate = 45.f;
+};
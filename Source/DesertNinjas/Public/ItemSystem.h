@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Engine/EngineTypes.h"
+#include "ItemDefinition.h"
+#include "ItemSystem.generated.h"
+
+class AItem;
+class ADesertNinjasCharacter;
+class UPrimitiveComponent;
+
+/**
+ * Runs every item that has a definition. Overlaps come straight from the items' collision
+ * volumes, are queued by effect type and resolved once per frame, one effect at a time, and
+ * idle rotation is done in one loop over the visible rotating items instead of each item ticking.
+ */
+UCLASS(config=Game)
+class DESERTNINJAS_API UItemSystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UItemSystem* Get(const UObject* WorldContextObject);
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End of FTickableGameObject interface
+
+	/** Active items with a definition; collected items are unregistered until reactivated */
+	void RegisterItem(AItem* Item);
+	void UnregisterItem(AItem* Item);
+
+	/** Drops the pending overlaps of a character leaving play */
+	void UnregisterCharacter(ADesertNinjasCharacter* Character);
+
+protected:
+	/** Bound to the collision volume of every registered item on the authority. Defined items are
+		Collectibles, which only character capsules overlap, so OtherActor is always a character. */
+	UFUNCTION()
+	void OnItemOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	struct FItemOverlap
+	{
+		AItem* Item;
+		ADesertNinjasCharacter* Character;
+		float Amount;
+	};
+
+	void ProcessOverlaps(EItemEffect Effect, TArray<FItemOverlap>& Overlaps);
+	void RotateItems(float DeltaTime);
+
+	/** Extra X distance around each item so it is already turning when it appears */
+	UPROPERTY(Config)
+	float CullMargin = 256.f;
+
+	TArray<FItemOverlap> PendingOverlaps[(int32)EItemEffect::EIE_MAX];
+
+	// Parallel arrays, each item keeps its slot in RotatingItemIndex
+	UPROPERTY(Transient)
+	TArray<AItem*> RotatingItems;
+	TArray<float> RotationRates;
+};
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LazyStamina.generated.h"
+
+/**
+ * Stamina stored as a value, a rate and the time it was last rebased.
+ * The current amount is computed on read, so nothing needs to tick while it
+ * regenerates or drains, and it only replicates when the rate changes.
+ */
+USTRUCT(BlueprintType)
+struct FLazyStamina
+{
+	GENERATED_BODY()
+
+	// Amount at Timestamp
+	UPROPERTY()
+	float Value = 0.f;
+
+	// Change per second, negative while draining
+	UPROPERTY()
+	float Rate = 0.f;
+
+	// Server world time Value was taken at
+	UPROPERTY()
+	float Timestamp = 0.f;
+
+	float Evaluate(float Now, float Max) const
+	{
+		return FMath::Clamp(Value + Rate * (Now - Timestamp), 0.f, Max);
+	}
+
+	/** Folds the elapsed time into Value and continues at NewRate */
+	void Rebase(float Now, float Max, float NewRate)
+	{
+		Value = Evaluate(Now, Max);
+		Timestamp = Now;
+		Rate = NewRate;
+	}
+
+	/** Seconds until stamina runs out or fills up at the current rate, or -1 if it never will */
+	float TimeToLimit(float Now, float Max) const
+	{
+		const float Current = Evaluate(Now, Max);
+		if (Rate < 0.f && Current > 0.f)
+		{
+			return Current / -Rate;
+		}
+		if (Rate > 0.f && Current < Max)
+		{
+			return (Max - Current) / Rate;
+		}
+		return -1.f;
+	}
+};
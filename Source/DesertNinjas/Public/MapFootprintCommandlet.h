@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MapFootprintCommandlet.generated.h"
+
+/**
+ * Lists long sound waves that aren't streamed (-FixStreaming marks and saves them), then
+ * loads each map and reports what it pulls in: referenced packages, their size on disk
+ * (total and not shared with other maps), load time and resident memory. The per-map numbers show what each map's chunk costs to download and
+ * load; see the AssetManagerSettings chunk rules in DefaultGame.ini.
+ *
+ * Usage:
+ *   UE4Editor-Cmd DesertNinjas.uproject -run=MapFootprint [-Map=/Game/Maps/A+/Game/Maps/B] [-StreamAudioOver=10] [-FixStreaming] [-Csv=Path]
+ */
+UCLASS()
+class UMapFootprintCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMapFootprintCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "UObject/Object.h"
+#include "MemoryBudget.generated.h"
+
+/** LLM tags for the gameplay subsystems, shown in "stat LLMFULL" and -llmcsv captures when run with -llm */
+enum class EDesertNinjasLLMTag : int32
+{
+	Items = (int32)ELLMTag::ProjectTagStart,
+	Characters,
+	Effects,
+	Platforms,
+	Gameplay,
+};
+
+#define DN_LLM_SCOPE(Tag) LLM_SCOPE((ELLMTag)EDesertNinjasLLMTag::Tag)
+
+USTRUCT()
+struct FMemoryBudget
+{
+	GENERATED_BODY()
+
+	/** Class name (e.g. Item, ParticleSystemComponent; subclasses are included) or LLM tag name (e.g. LLM.Items) */
+	UPROPERTY(Config)
+	FString Name;
+
+	/** 0 means no limit */
+	UPROPERTY(Config)
+	int32 MaxCount = 0;
+
+	/** 0 means no limit */
+	UPROPERTY(Config)
+	float MaxMB = 0.f;
+};
+
+/** One line of the memory report */
+struct FMemoryReportRow
+{
+	FString Name;
+	int32 Count = 0;
+	int64 Bytes = 0;
+	const FMemoryBudget* Budget = nullptr;
+
+	/** LLM tags measure the whole process, not the world the report was built for */
+	bool bProcessTotal = false;
+
+	bool IsOverBudget() const;
+};
+
+/**
+ * Per-level memory budgets, configured in DefaultGame.ini.
+ * Reported with the DesertNinjas.MemReport console command and the MemoryBudget commandlet.
+ */
+UCLASS(config=Game)
+class DESERTNINJAS_API UMemoryBudgetSettings : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(Config)
+	TArray<FMemoryBudget> Budgets;
+
+	/** Check the budgets whenever a game world begins play. Never done in Shipping; the commandlet is the main check. */
+	UPROPERTY(Config)
+	bool bCheckOnBeginPlay = false;
+};
+
+namespace DesertNinjasMemory
+{
+	void RegisterLLMTags();
+
+	/** Instance counts and bytes for every budgeted class in the world, plus the process wide LLM tag totals when run with -llm */
+	DESERTNINJAS_API void BuildReport(UWorld* World, TArray<FMemoryReportRow>& OutRows);
+
+	/** Prints the report; returns the number of budgets exceeded */
+	DESERTNINJAS_API int32 PrintReport(const TArray<FMemoryReportRow>& Rows, FOutputDevice& Ar);
+
+	/** Logs a warning for each exceeded budget; returns the number exceeded */
+	DESERTNINJAS_API int32 CheckBudgets(UWorld* World);
+}
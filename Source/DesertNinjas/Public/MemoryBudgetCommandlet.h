@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MemoryBudgetCommandlet.generated.h"
+
+/**
+ * Loads each map and prints the memory report for it. Returns non-zero when a budget
+ * is exceeded so CI catches memory regressions.
+ *
+ * Usage:
+ *   UE4Editor-Cmd DesertNinjas.uproject -run=MemoryBudget -Map=/Game/Maps/2DSideScrollerExampleMap[+/Game/Maps/Level]
+ */
+UCLASS()
+class UMemoryBudgetCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMemoryBudgetCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -25,4 +25,7 @@ public:
 	UFUNCTION(BlueprintImplementableEvent, Category = "Pickup")
 	void OnPickupBP(class ADesertNinjasCharacter* Target);
 
+protected:
+	virtual void PlayCollectedEvents(class ADesertNinjasCharacter* Collector) override;
+
 };
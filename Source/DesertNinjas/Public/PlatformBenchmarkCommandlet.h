@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PlatformBenchmarkCommandlet.generated.h"
+
+/**
+ * Ticks a headless world full of moving platforms with a character riding each one and
+ * reports the world tick time, once with the platforms set up as before they moved
+ * kinematically and once as they ship, plus how many riders stayed on their platform.
+ *
+ * Usage:
+ *   UE4Editor-Cmd DesertNinjas.uproject -run=PlatformBenchmark [-Platforms=300] [-Frames=600]
+ */
+UCLASS()
+class UPlatformBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPlatformBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DesertNinjas.h"
+#include "GameFramework/Actor.h"
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Net Relevancy Checks"), STAT_NetRelevancyChecks, STATGROUP_DesertNinjas, DESERTNINJAS_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Net Relevant Actors"), STAT_NetRelevantActors, STATGROUP_DesertNinjas, DESERTNINJAS_API);
+
+namespace SideScrollerRelevancy
+{
+	/** Everything happens in the XZ plane and the camera follows along X, so only the
+		horizontal distance to the viewer decides whether an actor is relevant */
+	inline bool IsRelevant(const AActor* Actor, const FVector& SrcLocation, float HalfWidth)
+	{
+		INC_DWORD_STAT(STAT_NetRelevancyChecks);
+
+		const bool bRelevant = Actor->bAlwaysRelevant
+			|| FMath::Abs(Actor->GetActorLocation().X - SrcLocation.X) <= HalfWidth;
+		if (bRelevant)
+		{
+			INC_DWORD_STAT(STAT_NetRelevantActors);
+		}
+		return bRelevant;
+	}
+}
@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SplitscreenCameraDirector.generated.h"
+
+class ACameraActor;
+
+/**
+ * Coordinates the cameras of all local players.
+ * While the players are close together they share one orthographic view whose width grows
+ * to fit them; once they drift apart the splitscreen views are restored.
+ * Once per frame it also builds the union of visible X ranges, which is used to stop
+ * registered actors from ticking while no view can see them.
+ */
+UCLASS(config=Game)
+class DESERTNINJAS_API USplitscreenCameraDirector : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	// End of FTickableGameObject interface
+
+	/** Returns true if any view can see part of [MinX, MaxX]. Always true when there is no local view. */
+	bool IsRangeVisible(float MinX, float MaxX) const;
+
+	/** Actors whose tick is only needed while they are on screen */
+	void RegisterCullable(AActor* Actor);
+	void UnregisterCullable(AActor* Actor);
+
+	bool IsMerged() const { return bMerged; }
+
+protected:
+	/** Widest ortho width of the shared view before the players are split */
+	UPROPERTY(Config)
+	float MaxMergedOrthoWidth = 3072.f;
+
+	/** The view never gets narrower than this */
+	UPROPERTY(Config)
+	float MinMergedOrthoWidth = 2048.f;
+
+	/** Space kept between the outermost players and the edge of the shared view */
+	UPROPERTY(Config)
+	float ScreenEdgeMargin = 400.f;
+
+	/** Players merge again once they fit into this fraction of the widest view, avoids flicker at the boundary */
+	UPROPERTY(Config)
+	float MergeHysteresis = 0.85f;
+
+	UPROPERTY(Config)
+	float OrthoWidthInterpSpeed = 4.f;
+
+	/** Extra X distance around each cullable actor so it resumes ticking just before it appears */
+	UPROPERTY(Config)
+	float CullMargin = 256.f;
+
+	struct FVisibleRange
+	{
+		float Min;
+		float Max;
+	};
+
+	void UpdateSharedView(const TArray<class APlayerController*>& Players, float DeltaTime);
+	void SetMerged(const TArray<class APlayerController*>& Players, bool bNewMerged);
+	void AddVisibleRange(float Min, float Max);
+	void UpdateCulling();
+
+	UPROPERTY(Transient)
+	ACameraActor* SharedCamera;
+
+	/** A set so that items registering and unregistering on collection stays cheap in big levels */
+	UPROPERTY(Transient)
+	TSet<AActor*> Cullables;
+
+	/** Sorted, non-overlapping view ranges for this frame */
+	TArray<FVisibleRange> VisibleRanges;
+
+	bool bMerged = false;
+	float SharedOrthoWidth = 0.f;
+};
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "SpriteAtlasTable.generated.h"
+
+class UTexture2D;
+
+/** Where a single sprite frame lives after atlas baking */
+USTRUCT(BlueprintType)
+struct FSpriteAtlasFrame
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Atlas")
+	int32 Page = 0;
+
+	// Top-left corner of the frame in the atlas page, in pixels
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Atlas")
+	FIntPoint Offset = FIntPoint::ZeroValue;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Atlas")
+	FIntPoint Size = FIntPoint::ZeroValue;
+};
+
+/**
+ * Frame lookup table generated by the BakeSpriteAtlas commandlet.
+ * Maps each baked sprite to its page and rectangle.
+ */
+UCLASS(BlueprintType)
+class DESERTNINJAS_API USpriteAtlasTable : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Atlas")
+	TArray<UTexture2D*> Pages;
+
+	/** Keyed by sprite object path */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Atlas")
+	TMap<FName, FSpriteAtlasFrame> Frames;
+
+	const FSpriteAtlasFrame* FindFrame(FName SpritePath) const { return Frames.Find(SpritePath); }
+};
@@ -0,0 +1,99 @@
+#!/usr/bin/env bash
+# Server capacity test: one dedicated server plus a growing number of headless bot clients
+# on this machine. Prints one CSV row per step with the server's tick time, bandwidth and
+# memory, averaged over the last seconds of the step.
+# Each bot also writes its input latency histograms to Saved/Profiling/InputLatency on exit.
+#
+# Usage:
+#   Tools/LoadTest/bot_load_test.sh [options]
+#     --binaries DIR   packaged build (default: Binaries/Linux)
+#     --map MAP        map to load (default: /Game/Maps/2DSideScrollerExampleMap)
+#     --max-bots N     stop after N bots (default: 32)
+#     --step N         bots added per step (default: 4)
+#     --step-time S    seconds per step (default: 30)
+#     --port P         server port (default: 7777)
+#     --script S       bot script passed as -BotScript (default: random walk)
+#     --out FILE       CSV output (default: Saved/LoadTest/results.csv)
+#     --net-profile    record a NetProfiler capture on the server (Saved/Profiling/*.nprof)
+
+set -euo pipefail
+
+BINARIES="Binaries/Linux"
+MAP="/Game/Maps/2DSideScrollerExampleMap"
+MAX_BOTS=32
+STEP=4
+STEP_TIME=30
+PORT=7777
+BOT_SCRIPT=""
+OUT="Saved/LoadTest/results.csv"
+SERVER_ARGS=()
+
+while [[ $# -gt 0 ]]; do
+	case "$1" in
+		--binaries) BINARIES="$2"; shift 2 ;;
+		--map) MAP="$2"; shift 2 ;;
+		--max-bots) MAX_BOTS="$2"; shift 2 ;;
+		--step) STEP="$2"; shift 2 ;;
+		--step-time) STEP_TIME="$2"; shift 2 ;;
+		--port) PORT="$2"; shift 2 ;;
+		--script) BOT_SCRIPT="$2"; shift 2 ;;
+		--out) OUT="$2"; shift 2 ;;
+		--net-profile) SERVER_ARGS+=(-networkprofiler=true); shift ;;
+		*) echo "Unknown option $1" >&2; exit 1 ;;
+	esac
+done
+
+SERVER="$BINARIES/DesertNinjasServer"
+CLIENT="$BINARIES/DesertNinjas"
+LOG_DIR="$(dirname "$OUT")"
+mkdir -p "$LOG_DIR"
+
+PIDS=()
+cleanup() {
+	for Pid in "${PIDS[@]}"; do
+		kill "$Pid" 2>/dev/null || true
+	done
+	wait 2>/dev/null || true
+}
+trap cleanup EXIT
+
+"$SERVER" "$MAP" -port="$PORT" -LoadTestReport ${SERVER_ARGS[@]+"${SERVER_ARGS[@]}"} -unattended -log -abslog="$LOG_DIR/server.log" &
+PIDS+=($!)
+sleep 10
+
+echo "bots,players,tick_avg_ms,tick_max_ms,in_kbps,out_kbps,mem_mb" | tee "$OUT"
+
+BOTS=0
+while [[ $BOTS -lt $MAX_BOTS ]]; do
+	for ((i = 0; i < STEP && BOTS < MAX_BOTS; i++)); do
+		BOT_ARGS=(-Bot -BotSeed="$BOTS")
+		if [[ -n "$BOT_SCRIPT" ]]; then
+			BOT_ARGS+=(-BotScript="$BOT_SCRIPT")
+		fi
+		"$CLIENT" "127.0.0.1:$PORT" -nullrhi -nosound -unattended -windowed -ResX=64 -ResY=64 \
+			"${BOT_ARGS[@]}" -InputLatencyCsv -log -abslog="$LOG_DIR/bot_$BOTS.log" >/dev/null 2>&1 &
+		PIDS+=($!)
+		BOTS=$((BOTS + 1))
+	done
+
+	sleep "$STEP_TIME"
+
+	# Average the reports from the second half of the step, the first half includes joins
+	SAMPLES=$((STEP_TIME / 2))
+	grep "LoadTestReport" "$LOG_DIR/server.log" | tail -n "$SAMPLES" | awk -v Bots="$BOTS" '
+		{
+			for (i = 1; i <= NF; i++) {
+				split($i, Pair, "=")
+				if (Pair[1] == "players") Players = Pair[2]
+				else if (Pair[1] == "tick_avg_ms") Avg += Pair[2]
+				else if (Pair[1] == "tick_max_ms" && Pair[2] > Max) Max = Pair[2]
+				else if (Pair[1] == "in_kbps") In += Pair[2]
+				else if (Pair[1] == "out_kbps") Out += Pair[2]
+				else if (Pair[1] == "mem_mb") Mem = Pair[2]
+			}
+			N++
+		}
+		END {
+			if (N > 0) printf "%d,%d,%.2f,%.2f,%.1f,%.1f,%.1f\n", Bots, Players, Avg / N, Max, In / N, Out / N, Mem
+		}' | tee -a "$OUT"
+done